@@ -0,0 +1,156 @@
+#include "async_writer.hpp"
+
+#include "out_buffer.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+async_writer::async_writer(size_t buffers, size_t size):
+  m_jobs(2 * buffers), m_free(buffers)
+{
+  for (size_t i = 0; i < buffers; ++i)
+    m_free.push(vector<char>(size));
+
+  m_thread = thread(&async_writer::run, this);
+}
+
+async_writer::~async_writer()
+{
+  try
+    {
+      finish();
+    }
+  catch (const system_error &)
+    {
+    }
+}
+
+vector<char>
+async_writer::buffer()
+{
+  vector<char> buf;
+  m_free.pop(buf);
+  return buf;
+}
+
+void
+async_writer::recycle(vector<char> buf)
+{
+  m_free.push(move(buf));
+}
+
+void
+async_writer::write(int fd, vector<char> buf, size_t n)
+{
+  {
+    lock_guard<mutex> lock(m_mutex);
+    if (m_error)
+      {
+        m_free.push(move(buf));
+        rethrow_exception(m_error);
+      }
+  }
+
+  m_jobs.push(job{fd, move(buf), n, false});
+}
+
+int
+async_writer::open(const string &path)
+{
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0)
+    throw system_error(errno, generic_category(), path);
+
+  lock_guard<mutex> lock(m_mutex);
+  m_names[fd] = path;
+  return fd;
+}
+
+void
+async_writer::close(int fd)
+{
+  m_jobs.push(job{fd, vector<char>(), 0, true});
+}
+
+void
+async_writer::finish()
+{
+  m_jobs.close();
+  if (m_thread.joinable())
+    m_thread.join();
+
+  lock_guard<mutex> lock(m_mutex);
+  if (m_error)
+    rethrow_exception(m_error);
+}
+
+void
+async_writer::fail(int fd, int error, const char *what)
+{
+  lock_guard<mutex> lock(m_mutex);
+  auto i = m_names.find(fd);
+  fail(error, i == m_names.end() ? what : i->second);
+}
+
+void
+async_writer::fail(int error, const string &what)
+{
+  if (!m_error)
+    m_error = make_exception_ptr
+      (system_error(error, generic_category(), what));
+}
+
+void
+async_writer::run()
+{
+  job j;
+
+  while (m_jobs.pop(j))
+    if (j.close)
+      {
+        // The name is forgotten before the descriptor is released,
+        // since open() in another thread may get the same number.
+        string name = "close";
+        {
+          lock_guard<mutex> lock(m_mutex);
+          auto i = m_names.find(j.fd);
+          if (i != m_names.end())
+            {
+              name = move(i->second);
+              m_names.erase(i);
+            }
+        }
+
+        if (::close(j.fd) < 0)
+          {
+            int error = errno;
+            lock_guard<mutex> lock(m_mutex);
+            fail(error, name);
+          }
+      }
+    else
+      {
+        bool failed;
+        {
+          lock_guard<mutex> lock(m_mutex);
+          failed = bool(m_error);
+        }
+
+        if (!failed)
+          try
+            {
+              write_all(j.fd, j.data.data(), j.size);
+            }
+          catch (const system_error &e)
+            {
+              fail(j.fd, e.code().value(), "write");
+            }
+
+        m_free.push(move(j.data));
+      }
+}
@@ -0,0 +1,97 @@
+#ifndef ASYNC_WRITER_HPP
+#define ASYNC_WRITER_HPP
+
+#include "bounded_queue.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * The writer thread.  The buffers filled by the other threads are
+ * queued, and written to their file descriptors in the order they
+ * were queued, so that the formatting and the writing overlap.
+ *
+ * The memory is bounded by a fixed pool of buffers: a thread takes a
+ * free buffer, fills it, and queues it, and the writer returns it to
+ * the pool once written.  A thread waits for a free buffer when the
+ * writer lags behind.
+ *
+ * A write error is reported with an exception (std::system_error),
+ * thrown by the next write() or by finish().  After an error, the
+ * writer drops the data, but still closes the files.
+ */
+class async_writer
+{
+public:
+  /**
+   * Start the writer with the given number of the buffers of the
+   * given size.  There should be at least one more buffer than the
+   * threads that hold one.
+   */
+  explicit async_writer(std::size_t buffers = 4,
+                        std::size_t size = 1 << 20);
+
+  /// Finish, but ignore the errors.
+  ~async_writer();
+
+  async_writer(const async_writer &) = delete;
+  async_writer &operator=(const async_writer &) = delete;
+
+  /// Take a free buffer, waiting for one.
+  std::vector<char>
+  buffer();
+
+  /// Return the unused buffer to the pool.
+  void
+  recycle(std::vector<char> buf);
+
+  /// Queue the first n characters of the buffer for writing.
+  void
+  write(int fd, std::vector<char> buf, std::size_t n);
+
+  /// Create the file, whose name is used in the error messages.
+  int
+  open(const std::string &path);
+
+  /// Queue closing the file once the queued data are written.
+  void
+  close(int fd);
+
+  /// Write everything queued, stop the thread, and report an error.
+  void
+  finish();
+
+private:
+  struct job
+  {
+    int fd;
+    std::vector<char> data;
+    std::size_t size;
+    bool close;
+  };
+
+  void
+  run();
+
+  // Record the error of the file, named what if not known.
+  void
+  fail(int fd, int error, const char *what);
+
+  // Record the error of the named file, with the mutex locked.
+  void
+  fail(int error, const std::string &what);
+
+  bounded_queue<job> m_jobs;
+  bounded_queue<std::vector<char>> m_free;
+  std::map<int, std::string> m_names;
+  std::exception_ptr m_error;
+  std::mutex m_mutex;
+  std::thread m_thread;
+};
+
+#endif /* ASYNC_WRITER_HPP */
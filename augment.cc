@@ -0,0 +1,189 @@
+#include "augment.hpp"
+
+#include "cuts.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+typedef cut_result::vertex_type vertex_type;
+
+// The largest number of the vertex pairs searched for the closest one.
+static const uint64_t max_pairs = 1 << 20;
+
+namespace
+{
+  /**
+   * The vertexes of the leaves to link, as the ranges of an array.
+   */
+  struct leaves
+  {
+    vector<uint64_t> offsets = {0};
+    vector<vertex_type> vertexes;
+
+    size_t
+    size() const
+    {
+      return offsets.size() - 1;
+    }
+
+    void
+    push(const vector<vertex_type> &l)
+    {
+      vertexes.insert(vertexes.end(), l.begin(), l.end());
+      offsets.push_back(vertexes.size());
+    }
+  };
+
+  // The leaves of the tree of the 2-edge-connected components: the
+  // components with one bridge.
+  leaves
+  component_leaves(const cut_result &c)
+  {
+    vector<uint32_t> bridges(c.components, 0);
+    for (const auto &b: c.bridges)
+      {
+        ++bridges[c.component[b.first]];
+        ++bridges[c.component[b.second]];
+      }
+
+    vector<vector<vertex_type>> members(c.components);
+    for (vertex_type v = 0; v < c.component.size(); ++v)
+      if (bridges[c.component[v]] == 1)
+        members[c.component[v]].push_back(v);
+
+    // The component of the root of the search is completed last, but
+    // comes first in the depth-first order.
+    if (!members.empty())
+      rotate(members.begin(), members.end() - 1, members.end());
+
+    leaves r;
+    for (const auto &m: members)
+      if (!m.empty())
+        r.push(m);
+
+    return r;
+  }
+
+  // The leaves of the tree of the blocks: the blocks with one
+  // articulation point, without the articulation point.
+  leaves
+  block_leaves(const cut_result &c)
+  {
+    vector<bool> articulation(c.component.size(), false);
+    for (vertex_type v: c.articulations)
+      articulation[v] = true;
+
+    leaves r;
+    vector<vertex_type> m;
+
+    for (size_t b = 0; b < c.blocks(); ++b)
+      {
+        m.clear();
+        int cuts = 0;
+        for (auto i = c.block_offsets[b]; i < c.block_offsets[b + 1]; ++i)
+          {
+            vertex_type v = c.block_vertexes[i];
+            if (articulation[v])
+              ++cuts;
+            else
+              m.push_back(v);
+          }
+
+        if (cuts == 1)
+          r.push(m);
+      }
+
+    return r;
+  }
+
+  // The distance between the vertexes, like that of the Gabriel edges.
+  COST
+  distance(const graph &g, vertex_type u, vertex_type v)
+  {
+    double dx = g[u].x - g[v].x, dy = g[u].y - g[v].y;
+    return int(sqrt(dx * dx + dy * dy) + 0.5);
+  }
+
+  /**
+   * Link leaf a with leaf b, and return true if the edge was added.
+   * The pairs of the vertexes already linked are skipped.
+   */
+  bool
+  link(graph &g, const leaves &l, size_t a, size_t b, const philox &eng,
+       int added)
+  {
+    bool located = g[boost::graph_bundle].located;
+    uint64_t pairs = 0;
+
+    // The best pair.
+    vertex_type bu = 0, bv = 0;
+    COST best = numeric_limits<COST>::infinity();
+
+    // Take the first pair, or the closest one of a limited number.
+    bool done = false;
+    for (auto i = l.offsets[a]; !done && i < l.offsets[a + 1]; ++i)
+      for (auto j = l.offsets[b]; !done && j < l.offsets[b + 1]; ++j)
+        {
+          vertex_type u = l.vertexes[i], v = l.vertexes[j];
+          if (boost::edge(u, v, g).second)
+            continue;
+
+          COST d = located ? distance(g, u, v) : 0;
+          if (d < best)
+            {
+              best = d;
+              bu = u;
+              bv = v;
+            }
+
+          done = !located || ++pairs >= max_pairs;
+        }
+
+    if (best == numeric_limits<COST>::infinity())
+      return false;
+
+    edge e = add_edge(bu, bv, g).first;
+    boost::get(boost::edge_weight, g, e) = located ? best :
+      1 + scale_to(eng.block(added)[0], 50);
+
+    return true;
+  }
+}
+
+int
+augment(graph &g, survivable_t survivable, const philox &eng)
+{
+  if (survivable == survivable_t::none)
+    return 0;
+
+  if (num_vertices(g) < 3)
+    throw logic_error("A survivable network needs at least three nodes.");
+
+  philox e = eng.split(augment_stream);
+  int added = 0;
+
+  while (true)
+    {
+      cut_result c = find_cuts(g);
+      leaves l = survivable == survivable_t::edge ?
+        component_leaves(c) : block_leaves(c);
+
+      if (l.size() < 2)
+        break;
+
+      size_t h = l.size() / 2;
+      for (size_t i = 0; i < h; ++i)
+        added += link(g, l, i, i + h, e, added);
+
+      // The odd leaf out.
+      if (l.size() % 2)
+        added += link(g, l, l.size() - 1, 0, e, added);
+    }
+
+  return added;
+}
@@ -0,0 +1,34 @@
+#ifndef AUGMENT_HPP
+#define AUGMENT_HPP
+
+#include "cli_args.hpp"
+#include "graph.hpp"
+#include "philox.hpp"
+
+// The stream of the distances of the added edges, after those of the
+// generators.
+enum augment_stream_t {augment_stream = 2};
+
+/**
+ * Add the edges to the connected graph to make it 2-edge-connected
+ * (without bridges), or 2-vertex-connected (without articulation
+ * points), and return the number of the edges added.
+ *
+ * In every round, the leaves of the tree of the components (for the
+ * 2-edge connectivity) or of the blocks (for the 2-vertex
+ * connectivity) are taken in the depth-first order, and leaf i is
+ * linked with leaf i + L / 2, where L is the number of the leaves.
+ * For the 2-edge connectivity this takes one round and ceil(L / 2)
+ * edges, which is the fewest possible.  For the 2-vertex connectivity
+ * the blocks on the path between the linked leaves merge, and the
+ * rounds are repeated until one block is left.
+ *
+ * An edge links the closest pair of the vertexes of the leaves, if
+ * the graph has the vertex locations, and gets their distance, like
+ * the Gabriel edges.  Otherwise, it links the first vertexes of the
+ * leaves, and gets the distance drawn like for the random edges.
+ */
+int
+augment(graph &g, survivable_t survivable, const philox &eng);
+
+#endif /* AUGMENT_HPP */
@@ -0,0 +1,208 @@
+#include "batch.hpp"
+
+#include "utils.hpp"
+
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/program_options.hpp>
+
+using namespace std;
+namespace po = boost::program_options;
+
+namespace
+{
+  int
+  to_int(const string &key, const string &s)
+  {
+    size_t end;
+    int x;
+
+    try
+      {
+        x = stoi(s, &end);
+      }
+    catch (const exception &)
+      {
+        end = 0;
+      }
+
+    if (end == 0 || end != s.size())
+      throw logic_error("Bad value of '" + key + "': " + s);
+
+    return x;
+  }
+
+  /**
+   * The values of the key: every value is split at the commas, and
+   * the ranges are expanded.
+   */
+  vector<int>
+  int_values(const po::variables_map &vm, const string &key)
+  {
+    vector<int> result;
+
+    for (const string &value: vm[key].as<vector<string>>())
+      {
+        vector<string> items;
+        boost::split(items, value, boost::is_any_of(","));
+
+        for (string item: items)
+          {
+            boost::trim(item);
+
+            size_t dots = item.find("..");
+            if (dots == string::npos)
+              {
+                result.push_back(to_int(key, item));
+                continue;
+              }
+
+            size_t colon = item.find(':', dots);
+            int first = to_int(key, item.substr(0, dots));
+            int last = to_int(key, item.substr(dots + 2, colon - dots - 2));
+            int step = colon == string::npos ? 1 :
+              to_int(key, item.substr(colon + 1));
+
+            if (step < 1 || first > last)
+              throw logic_error("Bad range of '" + key + "': " + item);
+
+            for (long x = first; x <= last; x += step)
+              result.push_back(x);
+          }
+      }
+
+    return result;
+  }
+
+  // The pattern with the edges given as a string.
+  string
+  expand(const string &pattern, const cli_args &job, const string &edges)
+  {
+    string result = pattern;
+
+    boost::replace_all(result, "{nt}", job.nt);
+    boost::replace_all(result, "{nodes}", to_string(job.nr_nodes));
+    boost::replace_all(result, "{edges}", edges);
+    boost::replace_all(result, "{seed}", to_string(job.seed));
+    boost::replace_all(result, "{format}", job.format);
+    boost::replace_all(result, "{ext}",
+                       job.format + (job.gzip ? ".gz" : ""));
+
+    return result;
+  }
+}
+
+batch
+read_batch(const string &path, const cli_args &args)
+{
+  po::options_description opts;
+  opts.add_options()
+    ("nt", po::value<vector<string>>()->required())
+    ("nodes", po::value<vector<string>>()->required())
+    ("edges", po::value<vector<string>>())
+    ("seed", po::value<vector<string>>())
+    ("output", po::value<string>()->default_value
+     ("{nt}-{nodes}-{edges}-{seed}.{ext}"));
+
+  ifstream in(path);
+  if (!in)
+    throw logic_error("Cannot open the batch file '" + path + "'.");
+
+  po::variables_map vm;
+  try
+    {
+      po::store(po::parse_config_file(in, opts), vm);
+      po::notify(vm);
+    }
+  catch (const po::error &e)
+    {
+      throw logic_error(path + ": " + e.what());
+    }
+
+  vector<string> nts;
+  for (const string &value: vm["nt"].as<vector<string>>())
+    {
+      vector<string> items;
+      boost::split(items, value, boost::is_any_of(","));
+      for (string item: items)
+        {
+          boost::trim(item);
+          nts.push_back(item);
+        }
+    }
+
+  vector<int> nodes = int_values(vm, "nodes");
+  vector<int> edges;
+  if (vm.count("edges"))
+    edges = int_values(vm, "edges");
+  vector<int> seeds(1, args.seed);
+  if (vm.count("seed"))
+    seeds = int_values(vm, "seed");
+
+  batch result;
+  result.output = vm["output"].as<string>();
+
+  for (const string &nt: nts)
+    {
+      bool random = nt_interpret(nt) == nt_t::random_network;
+
+      if (random && edges.empty())
+        throw logic_error(path + ": the random network requires 'edges'.");
+
+      for (int n: nodes)
+        {
+          if (n < 2)
+            throw logic_error(path + ": too few nodes: " + to_string(n));
+
+          // The number of edges is given for the random network only.
+          vector<boost::optional<int>> es(1);
+          if (random)
+            es.assign(edges.begin(), edges.end());
+
+          for (const boost::optional<int> &e: es)
+            {
+              if (e && (e.get() < n - 1 ||
+                        e.get() > (long long) n * (n - 1) / 2))
+                throw logic_error(path + ": cannot connect " + to_string(n)
+                                  + " nodes with " + to_string(e.get())
+                                  + " edges.");
+
+              for (int seed: seeds)
+                {
+                  cli_args job = args;
+                  job.nt = nt;
+                  job.nr_nodes = n;
+                  job.nr_edges = e;
+                  job.seed = seed;
+                  result.jobs.push_back(job);
+                }
+            }
+        }
+    }
+
+  // The jobs have to write to different files.  The number of edges
+  // is known in advance for the random network only, so for the other
+  // networks it cannot tell the files apart.
+  set<string> paths;
+  for (const cli_args &job: result.jobs)
+    {
+      string edges = job.nr_edges ? to_string(job.nr_edges.get()) :
+        "{edges}";
+      string p = expand(result.output, job, edges);
+      if (!paths.insert(p).second)
+        throw logic_error(path + ": the jobs write to the same file '"
+                          + p + "'.");
+    }
+
+  return result;
+}
+
+string
+batch_path(const string &pattern, const cli_args &job, size_t nr_edges)
+{
+  return expand(pattern, job, to_string(nr_edges));
+}
@@ -0,0 +1,56 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "cli_args.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * The batch of the graphs to generate in one run.
+ */
+struct batch
+{
+  /// The pattern of the output file names.
+  std::string output;
+
+  /// The arguments of every graph.
+  std::vector<cli_args> jobs;
+};
+
+/**
+ * Read the batch file, which gives the grid of the parameters in the
+ * format of a configuration file of Boost.Program_options:
+ *
+ *   nt = random
+ *   nt = gabriel
+ *   nodes = 100..1000:100
+ *   edges = 2000, 4000
+ *   seed = 1..50
+ *   output = graphs/{nt}-{nodes}-{edges}-{seed}.{ext}
+ *
+ * A key can be repeated, and a value can be a list separated with
+ * commas, and an integer range: first..last, or first..last:step.  A
+ * job is made for every combination of the network type, the number
+ * of nodes, the number of edges (for the random network only), and
+ * the seed, with the other arguments taken from the command line.
+ *
+ * Throws std::logic_error on a bad file, or if two jobs would write
+ * to the same file, because the output pattern does not tell them
+ * apart.
+ */
+batch
+read_batch(const std::string &path, const cli_args &args);
+
+/**
+ * The output file name of the job: the pattern with {nt}, {nodes},
+ * {edges}, {seed}, {format} and {ext} (the format, and ".gz" if
+ * compressed) replaced.  The number of edges is that of the
+ * generated graph.
+ */
+std::string
+batch_path(const std::string &pattern, const cli_args &job,
+           std::size_t nr_edges);
+
+#endif /* BATCH_HPP */
@@ -0,0 +1,130 @@
+#include "betweenness.hpp"
+
+#include "parallel.hpp"
+#include "sampling.hpp"
+#include "sssp.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace std;
+
+typedef csr_graph::vertex_type vertex_type;
+
+// The scale of the fixed-point accumulators.
+static const double fixed_scale = 1 << 16;
+
+betweenness_result
+betweenness(const csr_graph &g, unsigned threads, uint32_t samples,
+            const philox &eng)
+{
+  vertex_type n = g.nr_vertices();
+
+  // The sources: all nodes, or the sample.
+  vector<vertex_type> sources;
+  if (samples && samples < n)
+    {
+      philox e = eng.split(betweenness_stream);
+      sources.reserve(samples);
+      sample_sorted(samples, n, e, [&](uint64_t v)
+                    {sources.push_back(v);});
+    }
+  else
+    {
+      sources.resize(n);
+      iota(sources.begin(), sources.end(), 0);
+    }
+
+  // The state and the accumulators of the threads.
+  struct state
+  {
+    sssp sp;
+    vector<double> delta;
+    vector<int64_t> node;
+    vector<int64_t> arc;
+  };
+
+  threads = min<size_t>(nr_threads(threads), max<size_t>(sources.size(), 1));
+  vector<state> states(threads);
+
+  parallel_for(sources.size(), threads, [&](size_t i, unsigned t)
+    {
+      state &s = states[t];
+      if (s.node.empty())
+        {
+          s.delta.resize(n);
+          s.node.assign(n, 0);
+          s.arc.assign(g.nr_arcs(), 0);
+        }
+
+      vertex_type src = sources[i];
+      s.sp.run(g, src);
+
+      const vector<vertex_type> &order = s.sp.order();
+      for (vertex_type v: order)
+        s.delta[v] = 0;
+
+      // Accumulate the dependencies from the farthest node back.  The
+      // predecessors of node w are the neighbors v with a tight arc.
+      for (auto j = order.rbegin(); j != order.rend(); ++j)
+        {
+          vertex_type w = *j;
+          double coeff = (1 + s.delta[w]) / s.sp.sigma(w);
+
+          for (auto a = g.offset(w); a < g.offset(w + 1); ++a)
+            {
+              vertex_type v = g.targets()[a];
+              if (s.sp.dist(v) + g.weights()[a] == s.sp.dist(w))
+                {
+                  double x = s.sp.sigma(v) * coeff;
+                  s.delta[v] += x;
+                  s.arc[a] += llround(x * fixed_scale);
+                }
+            }
+
+          if (w != src)
+            s.node[w] += llround(s.delta[w] * fixed_scale);
+        }
+    });
+
+  // Every pair of nodes was counted from both ends, and the sample is
+  // scaled up to all the sources.
+  double scale = sources.empty() ? 0 :
+    double(n) / sources.size() / 2 / fixed_scale;
+
+  betweenness_result r;
+  r.sources = sources.size();
+
+  r.node.assign(n, 0);
+  for (vertex_type v = 0; v < n; ++v)
+    {
+      int64_t sum = 0;
+      for (const state &s: states)
+        if (!s.node.empty())
+          sum += s.node[v];
+      r.node[v] = sum * scale;
+    }
+
+  // The load of a link is the load of its two arcs.
+  r.link.reserve(g.nr_edges());
+  for (vertex_type v = 0; v < n; ++v)
+    for (auto a = g.offset(v); a < g.offset(v + 1); ++a)
+      {
+        vertex_type u = g.targets()[a];
+        if (u < v)
+          continue;
+
+        const uint32_t *first = g.targets() + g.offset(u);
+        const uint32_t *last = g.targets() + g.offset(u + 1);
+        uint64_t b = lower_bound(first, last, v) - g.targets();
+
+        int64_t sum = 0;
+        for (const state &s: states)
+          if (!s.arc.empty())
+            sum += s.arc[a] + s.arc[b];
+        r.link.push_back(sum * scale);
+      }
+
+  return r;
+}
@@ -0,0 +1,51 @@
+#ifndef BETWEENNESS_HPP
+#define BETWEENNESS_HPP
+
+#include "csr_graph.hpp"
+#include "philox.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// The stream of the sampled sources, apart from those of the
+// generators and of the percolation.
+enum betweenness_stream_t {betweenness_stream = (1 << 16) + 1};
+
+/**
+ * The betweenness of the nodes and the links, i.e., their load when
+ * there is one unit of demand between every pair of nodes, split
+ * evenly over the shortest paths between the nodes.
+ */
+struct betweenness_result
+{
+  /// The load of every node, not counting the demands of the node.
+  std::vector<double> node;
+
+  /// The load of every link, in the order of the arcs from the
+  /// smaller to the larger vertex.
+  std::vector<double> link;
+
+  /// The number of the sources the load was accumulated from.
+  std::uint32_t sources;
+};
+
+/**
+ * Calculate the betweenness with Brandes' algorithm: for every
+ * source, the shortest paths are found, and then the dependencies of
+ * the source on the nodes and the links are accumulated from the
+ * farthest node back.  The sources are run in parallel on the given
+ * number of threads, each thread with its accumulators.
+ *
+ * The accumulators are in fixed point (with 16 fractional bits), so
+ * that their sums are exact, and the result doesn't depend on the
+ * number of threads.
+ *
+ * If samples is not zero and smaller than the number of nodes, the
+ * load is estimated from that many sources drawn at random, and
+ * scaled up to all sources.
+ */
+betweenness_result
+betweenness(const csr_graph &g, unsigned threads, std::uint32_t samples,
+            const philox &eng);
+
+#endif /* BETWEENNESS_HPP */
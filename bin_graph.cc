@@ -0,0 +1,170 @@
+#include "bin_graph.hpp"
+#include "mapped_file.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+static const char bin_magic[8] = {'N', 'E', 'T', 'G', 'E', 'N', 0, 0};
+
+bool
+is_bin_graph(const char *data, size_t size)
+{
+  return size >= sizeof(bin_magic) &&
+    !memcmp(data, bin_magic, sizeof(bin_magic));
+}
+
+void
+write_bin(out_buffer &out, const csr_graph &g, const vertex_names *names)
+{
+  uint64_t n = g.nr_vertices();
+  uint64_t m = g.nr_arcs();
+
+  // The offsets and the characters of the names, if needed.
+  vector<uint64_t> name_offsets;
+  vector<char> name_chars;
+  if (names)
+    {
+      name_offsets.reserve(n + 1);
+      name_chars.reserve(n * 8);
+      char buf[vertex_names::max_size];
+      name_offsets.push_back(0);
+      for (uint64_t v = 0; v < n; ++v)
+        {
+          name_chars.insert(name_chars.end(), buf, names->format(buf, v));
+          name_offsets.push_back(name_chars.size());
+        }
+    }
+
+  bin_header h = {};
+  memcpy(h.magic, bin_magic, sizeof(h.magic));
+  h.version = bin_version;
+  h.byte_order = 0x01020304;
+  h.nr_vertices = n;
+  h.nr_arcs = m;
+
+  uint64_t pos = align8(sizeof(bin_header));
+  h.offsets = pos;
+  pos += align8((n + 1) * sizeof(uint64_t));
+  h.targets = pos;
+  pos += align8(m * sizeof(uint32_t));
+  h.weights = pos;
+  pos += align8(m * sizeof(COST));
+  if (g.locations())
+    {
+      h.locations = pos;
+      pos += align8(n * sizeof(location));
+    }
+  if (names)
+    {
+      h.name_offsets = pos;
+      pos += align8((n + 1) * sizeof(uint64_t));
+      h.names = pos;
+      pos += align8(name_chars.size());
+    }
+  h.size = pos;
+
+  put_array(out, &h, 1);
+  put_array(out, g.offsets(), n + 1);
+  put_array(out, g.targets(), m);
+  put_array(out, g.weights(), m);
+  if (g.locations())
+    put_array(out, g.locations(), n);
+  if (names)
+    {
+      put_array(out, name_offsets.data(), n + 1);
+      put_array(out, name_chars.data(), name_chars.size());
+    }
+}
+
+void
+check_section(uint64_t header, uint64_t size, uint64_t pos, uint64_t bytes,
+              const char *what)
+{
+  if (pos % 8 || pos < header || pos > size || bytes > size - pos)
+    throw runtime_error(string("bad ") + what + " section");
+}
+
+void
+check_offsets(const uint64_t *offsets, uint64_t n, uint64_t m,
+              const char *what)
+{
+  if (offsets[0] != 0 || offsets[n] != m)
+    throw runtime_error(string("bad ") + what);
+  for (uint64_t i = 0; i < n; ++i)
+    if (offsets[i] > offsets[i + 1])
+      throw runtime_error(string("bad ") + what);
+}
+
+void
+check_indexes(const uint32_t *a, uint64_t n, uint64_t limit,
+              const char *what)
+{
+  for (uint64_t i = 0; i < n; ++i)
+    if (a[i] >= limit)
+      throw runtime_error(string("bad ") + what);
+}
+
+// Check the section of the binary graph.
+static void
+check_section(const bin_header &h, uint64_t pos, uint64_t bytes,
+              const char *what)
+{
+  check_section(sizeof(bin_header), h.size, pos, bytes, what);
+}
+
+csr_graph
+load_bin(const string &path)
+{
+  auto mf = make_shared<mapped_file>(path);
+  const char *base = mf->data();
+
+  try
+    {
+      const bin_header &h = check_header<bin_header>
+        (base, mf->size(), bin_magic, bin_version, "binary graph");
+      if (h.nr_vertices >= UINT32_MAX || h.nr_arcs > h.size)
+        throw runtime_error("bad graph size");
+
+      uint64_t n = h.nr_vertices;
+      uint64_t m = h.nr_arcs;
+      check_section(h, h.offsets, (n + 1) * sizeof(uint64_t), "offsets");
+      check_section(h, h.targets, m * sizeof(uint32_t), "targets");
+      check_section(h, h.weights, m * sizeof(COST), "weights");
+
+      csr_graph::arrays a;
+      a.offsets = reinterpret_cast<const uint64_t *>(base + h.offsets);
+      a.targets = reinterpret_cast<const uint32_t *>(base + h.targets);
+      a.weights = reinterpret_cast<const COST *>(base + h.weights);
+
+      check_offsets(a.offsets, n, m, "offsets");
+      check_indexes(a.targets, m, n, "targets");
+
+      if (h.locations)
+        {
+          check_section(h, h.locations, n * sizeof(location), "locations");
+          a.locations =
+            reinterpret_cast<const location *>(base + h.locations);
+        }
+
+      if (h.name_offsets)
+        {
+          check_section(h, h.name_offsets, (n + 1) * sizeof(uint64_t),
+                        "name offsets");
+          a.name_offsets =
+            reinterpret_cast<const uint64_t *>(base + h.name_offsets);
+          check_offsets(a.name_offsets, n, a.name_offsets[n],
+                        "name offsets");
+          check_section(h, h.names, a.name_offsets[n], "names");
+          a.names = base + h.names;
+        }
+
+      return csr_graph(n, m, a, mf);
+    }
+  catch (const runtime_error &e)
+    {
+      throw runtime_error(path + ": " + e.what());
+    }
+}
@@ -0,0 +1,157 @@
+#ifndef BIN_GRAPH_HPP
+#define BIN_GRAPH_HPP
+
+#include "csr_graph.hpp"
+#include "names.hpp"
+#include "out_buffer.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/**
+ * The header of the binary graph format.  The file is made of the
+ * header and the sections of the CSR graph:
+ *
+ * - the offsets: nr_vertices + 1 numbers of uint64_t,
+ *
+ * - the targets: nr_arcs numbers of uint32_t,
+ *
+ * - the weights: nr_arcs numbers of double,
+ *
+ * - optionally, the locations: nr_vertices pairs of double (x, y),
+ *
+ * - optionally, the names: nr_vertices + 1 offsets of uint64_t into
+ *   the characters of the names that follow them.
+ *
+ * The numbers are in the byte order of the machine that wrote the
+ * file, which the loader checks.  Every section starts at a multiple
+ * of 8 bytes at the position given in the header, or 0 if absent, so
+ * that a mapped file can be used in place.
+ */
+struct bin_header
+{
+  // The magic number, "NETGEN" followed by two zeros.
+  char magic[8];
+  // The version of the format.
+  std::uint32_t version;
+  // The number 0x01020304 as written by the writer.
+  std::uint32_t byte_order;
+
+  std::uint64_t nr_vertices;
+  std::uint64_t nr_arcs;
+
+  // The positions of the sections in the file.
+  std::uint64_t offsets;
+  std::uint64_t targets;
+  std::uint64_t weights;
+  std::uint64_t locations;
+  std::uint64_t name_offsets;
+  std::uint64_t names;
+
+  // The size of the file.
+  std::uint64_t size;
+};
+
+// The version of the binary format written.
+constexpr std::uint32_t bin_version = 1;
+
+// Round up to the multiple of 8.
+inline std::uint64_t
+align8(std::uint64_t x)
+{
+  return (x + 7) & ~std::uint64_t(7);
+}
+
+/**
+ * Write the array of the binary format, and pad it to the multiple
+ * of 8 bytes.
+ */
+template <typename T>
+void
+put_array(out_buffer &out, const T *a, std::uint64_t n)
+{
+  out.put(reinterpret_cast<const char *>(a), n * sizeof(T));
+  static const char zeros[8] = {};
+  out.put(zeros, align8(n * sizeof(T)) - n * sizeof(T));
+}
+
+/**
+ * Check the header of type H of a file in one of the binary formats:
+ * the magic number, the byte order, the version, and the size of the
+ * file.  The header has these as its fields magic, byte_order,
+ * version and size.  Returns the header at the start of the data, or
+ * throws std::runtime_error, saying the data is not a what.
+ */
+template <typename H>
+const H &
+check_header(const char *data, std::uint64_t size, const char *magic,
+             std::uint32_t version, const char *what)
+{
+  const H &h = *reinterpret_cast<const H *>(data);
+
+  if (size < sizeof(H) || std::memcmp(h.magic, magic, sizeof(h.magic)))
+    throw std::runtime_error(std::string("not a ") + what);
+  if (h.byte_order != 0x01020304)
+    throw std::runtime_error("wrong byte order");
+  if (h.version != version)
+    throw std::runtime_error("unsupported version "
+                             + std::to_string(h.version));
+  if (h.size != size)
+    throw std::runtime_error("wrong file size");
+
+  return h;
+}
+
+/**
+ * Check the section of the file of the given size at position pos,
+ * which has to be aligned, come after the header, and fit in the
+ * file.  Throws std::runtime_error otherwise.
+ */
+void
+check_section(std::uint64_t header, std::uint64_t size, std::uint64_t pos,
+              std::uint64_t bytes, const char *what);
+
+/**
+ * Check the offsets of the n + 1 ranges into an array of m elements,
+ * which have to start at 0, never decrease, and end at m.  Throws
+ * std::runtime_error otherwise.
+ */
+void
+check_offsets(const std::uint64_t *offsets, std::uint64_t n,
+              std::uint64_t m, const char *what);
+
+/**
+ * Check that the n indexes are less than limit.  Throws
+ * std::runtime_error otherwise.
+ */
+void
+check_indexes(const std::uint32_t *a, std::uint64_t n,
+              std::uint64_t limit, const char *what);
+
+/**
+ * True if the data start with the magic number of the binary format.
+ */
+bool
+is_bin_graph(const char *data, std::size_t size);
+
+/**
+ * Write the graph in the binary format.  The locations are written
+ * if the graph has them, and the names if the names are given.
+ */
+void
+write_bin(out_buffer &out, const csr_graph &g,
+          const vertex_names *names = nullptr);
+
+/**
+ * Map the file in the binary format into memory, and return the
+ * graph that is the view of the mapped file.  Nothing is copied, and
+ * the file stays mapped for as long as a copy of the graph lives.
+ * Throws std::runtime_error if the file cannot be mapped or is not
+ * valid.
+ */
+csr_graph
+load_bin(const std::string &path);
+
+#endif /* BIN_GRAPH_HPP */
@@ -0,0 +1,79 @@
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * The blocking queue of a bounded capacity, which connects the stages
+ * of a pipeline: the producer waits when the queue is full, and the
+ * consumer waits when it is empty.  Once closed, the queue takes no
+ * more items, but the items already queued can still be taken.
+ */
+template <typename T>
+class bounded_queue
+{
+  std::size_t m_capacity;
+  std::deque<T> m_items;
+  bool m_closed = false;
+  std::mutex m_mutex;
+  std::condition_variable m_not_empty;
+  std::condition_variable m_not_full;
+
+public:
+  explicit bounded_queue(std::size_t capacity):
+    m_capacity(capacity)
+  {
+  }
+
+  /**
+   * Put the item at the end of the queue, waiting for room.
+   *
+   * @return false if the queue is closed, and the item was dropped
+   */
+  bool
+  push(T item)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_full.wait(lock, [this]
+                    {return m_closed || m_items.size() < m_capacity;});
+    if (m_closed)
+      return false;
+    m_items.push_back(std::move(item));
+    m_not_empty.notify_one();
+    return true;
+  }
+
+  /**
+   * Take the item from the front of the queue, waiting for one.
+   *
+   * @return false if the queue is closed and empty
+   */
+  bool
+  pop(T &item)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_empty.wait(lock, [this] {return m_closed || !m_items.empty();});
+    if (m_items.empty())
+      return false;
+    item = std::move(m_items.front());
+    m_items.pop_front();
+    m_not_full.notify_one();
+    return true;
+  }
+
+  /// Close the queue, and wake up everybody waiting.
+  void
+  close()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+  }
+};
+
+#endif /* BOUNDED_QUEUE_HPP */
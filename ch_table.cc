@@ -0,0 +1,272 @@
+#include "ch_table.hpp"
+#include "bin_graph.hpp"
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+typedef ch_table::vertex_type vertex_type;
+
+static const char ch_magic[8] = {'N', 'G', 'C', 'H', 0, 0, 0, 0};
+
+static const COST infinity = numeric_limits<COST>::infinity();
+
+constexpr uint32_t ch_set::none;
+
+void
+write_ch(out_buffer &out, const ch_set &s)
+{
+  uint64_t n = s.ranks.size();
+  uint64_t m = s.targets.size();
+
+  ch_header h = {};
+  memcpy(h.magic, ch_magic, sizeof(h.magic));
+  h.version = ch_version;
+  h.byte_order = 0x01020304;
+  h.nr_vertices = n;
+  h.nr_arcs = m;
+  h.checksum = s.checksum;
+
+  uint64_t pos = align8(sizeof(ch_header));
+  h.ranks = pos;
+  pos += align8(n * sizeof(uint32_t));
+  h.offsets = pos;
+  pos += align8((n + 1) * sizeof(uint64_t));
+  h.targets = pos;
+  pos += align8(m * sizeof(uint32_t));
+  h.weights = pos;
+  pos += align8(m * sizeof(COST));
+  h.middles = pos;
+  pos += align8(m * sizeof(uint32_t));
+  h.size = pos;
+
+  put_array(out, &h, 1);
+  put_array(out, s.ranks.data(), n);
+  put_array(out, s.offsets.data(), n + 1);
+  put_array(out, s.targets.data(), m);
+  put_array(out, s.weights.data(), m);
+  put_array(out, s.middles.data(), m);
+}
+
+ch_table::ch_table(const string &path):
+  m_file(make_shared<mapped_file>(path))
+{
+  const char *base = m_file->data();
+
+  try
+    {
+      const ch_header &h = check_header<ch_header>
+        (base, m_file->size(), ch_magic, ch_version,
+         "contraction hierarchy");
+      if (h.nr_vertices >= UINT32_MAX || h.nr_arcs > h.size)
+        throw runtime_error("bad hierarchy size");
+
+      uint64_t n = h.nr_vertices;
+      uint64_t m = h.nr_arcs;
+      check_section(sizeof(h), h.size, h.ranks, n * sizeof(uint32_t),
+                    "ranks");
+      check_section(sizeof(h), h.size, h.offsets,
+                    (n + 1) * sizeof(uint64_t), "offsets");
+      check_section(sizeof(h), h.size, h.targets, m * sizeof(uint32_t),
+                    "targets");
+      check_section(sizeof(h), h.size, h.weights, m * sizeof(COST),
+                    "weights");
+      check_section(sizeof(h), h.size, h.middles, m * sizeof(uint32_t),
+                    "middles");
+
+      m_h = &h;
+      m_ranks = reinterpret_cast<const uint32_t *>(base + h.ranks);
+      m_offsets = reinterpret_cast<const uint64_t *>(base + h.offsets);
+      m_targets = reinterpret_cast<const uint32_t *>(base + h.targets);
+      m_weights = reinterpret_cast<const COST *>(base + h.weights);
+      m_middles = reinterpret_cast<const uint32_t *>(base + h.middles);
+
+      check_offsets(m_offsets, n, m, "offsets");
+      check_indexes(m_targets, m, n, "targets");
+
+      for (vertex_type u = 0; u < n; ++u)
+        for (auto a = m_offsets[u]; a < m_offsets[u + 1]; ++a)
+          {
+            // The arcs in the core go both ways.
+            vertex_type v = m_targets[a];
+            if (m_ranks[v] < m_ranks[u] ||
+                (a > m_offsets[u] && m_targets[a - 1] >= v) ||
+                (m_ranks[v] == m_ranks[u] && find(v, u) == m))
+              throw runtime_error("bad targets");
+
+            // The unpacking of the shortcut ends, since the ranks of
+            // the middles go down.
+            vertex_type x = m_middles[a];
+            if (x != ch_set::none &&
+                (x >= n || m_ranks[x] >= m_ranks[u] ||
+                 find(x, u) == m || find(x, v) == m))
+              throw runtime_error("bad middles");
+          }
+    }
+  catch (const runtime_error &e)
+    {
+      throw runtime_error(path + ": " + e.what());
+    }
+}
+
+uint64_t
+ch_table::arc(vertex_type u, vertex_type v) const
+{
+  if (m_ranks[u] > m_ranks[v])
+    swap(u, v);
+
+  const uint32_t *b = m_targets + m_offsets[u];
+  const uint32_t *e = m_targets + m_offsets[u + 1];
+  return lower_bound(b, e, v) - m_targets;
+}
+
+uint64_t
+ch_table::find(vertex_type u, vertex_type v) const
+{
+  if (m_ranks[u] > m_ranks[v])
+    swap(u, v);
+
+  uint64_t a = arc(u, v);
+  return a < m_offsets[u + 1] && m_targets[a] == v ? a : nr_arcs();
+}
+
+ch_query::ch_query(const ch_table &t):
+  m_t(t)
+{
+  for (search &s: m_s)
+    {
+      s.labels.assign(t.nr_vertices(), label());
+    }
+}
+
+void
+ch_query::step(search &a, const search &b)
+{
+  greater<pair<COST, vertex_type>> cmp;
+
+  pop_heap(a.heap.begin(), a.heap.end(), cmp);
+  auto [d, u] = a.heap.back();
+  a.heap.pop_back();
+
+  if (d > a.labels[u].dist)
+    return;
+  ++m_settled;
+
+  // The searches meet.
+  const label &l = b.labels[u];
+  if (l.stamp == m_time && d + l.dist < m_best)
+    {
+      m_best = d + l.dist;
+      m_meet = u;
+    }
+
+  // Stall the vertex reached from above by a shorter path.
+  for (auto i = m_t.offset(u); i < m_t.offset(u + 1); ++i)
+    {
+      const label &x = a.labels[m_t.target(i)];
+      if (x.stamp == m_time && x.dist + m_t.weight(i) < d)
+        return;
+    }
+
+  for (auto i = m_t.offset(u); i < m_t.offset(u + 1); ++i)
+    {
+      vertex_type x = m_t.target(i);
+      COST nd = d + m_t.weight(i);
+
+      label &l = a.labels[x];
+      if (l.stamp != m_time || nd < l.dist)
+        {
+          l = {nd, m_time, u};
+          a.heap.emplace_back(nd, x);
+          push_heap(a.heap.begin(), a.heap.end(), cmp);
+        }
+    }
+}
+
+COST
+ch_query::distance(vertex_type s, vertex_type t)
+{
+  if (++m_time == 0)
+    {
+      for (search &a: m_s)
+        fill(a.labels.begin(), a.labels.end(), label());
+      m_time = 1;
+    }
+
+  m_meet = ch_set::none;
+  m_best = infinity;
+  m_settled = 0;
+
+  vertex_type ends[2] = {s, t};
+  for (int i = 0; i < 2; ++i)
+    {
+      search &a = m_s[i];
+      a.heap.clear();
+      a.labels[ends[i]] = {0, m_time, ch_set::none};
+      a.heap.emplace_back(0, ends[i]);
+    }
+
+  // A search stops when its nearest vertex is not nearer than the
+  // best path found.
+  while (true)
+    {
+      bool go[2];
+      for (int i = 0; i < 2; ++i)
+        go[i] = !m_s[i].heap.empty() && m_s[i].heap.front().first < m_best;
+
+      if (!go[0] && !go[1])
+        break;
+
+      int i = go[0] && (!go[1] ||
+                        m_s[0].heap.front() <= m_s[1].heap.front()) ? 0 : 1;
+      step(m_s[i], m_s[1 - i]);
+    }
+
+  return m_best;
+}
+
+void
+ch_query::path(vector<vertex_type> &p) const
+{
+  p.clear();
+  if (m_meet == ch_set::none)
+    return;
+
+  // The vertexes of the searches from the meeting vertex back to s
+  // and to t.
+  vector<vertex_type> up;
+  for (vertex_type v = m_meet; v != ch_set::none; v = m_s[0].labels[v].pred)
+    up.push_back(v);
+  reverse(up.begin(), up.end());
+  for (vertex_type v = m_s[1].labels[m_meet].pred; v != ch_set::none;
+       v = m_s[1].labels[v].pred)
+    up.push_back(v);
+
+  // Unpack the arcs: a shortcut is replaced by the two arcs to its
+  // middle vertex, until only the edges are left.
+  p.push_back(up.front());
+  vector<pair<vertex_type, vertex_type>> stack;
+  for (size_t i = 0; i + 1 < up.size(); ++i)
+    {
+      stack.emplace_back(up[i], up[i + 1]);
+      while (!stack.empty())
+        {
+          auto [u, v] = stack.back();
+          stack.pop_back();
+
+          vertex_type m = m_t.middle(m_t.arc(u, v));
+          if (m == ch_set::none)
+            p.push_back(v);
+          else
+            {
+              stack.emplace_back(m, v);
+              stack.emplace_back(u, m);
+            }
+        }
+    }
+}
@@ -0,0 +1,244 @@
+#ifndef CH_TABLE_HPP
+#define CH_TABLE_HPP
+
+#include "csr_graph.hpp"
+#include "out_buffer.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class mapped_file;
+
+/**
+ * The contraction hierarchy of the graph: the vertexes are ranked in
+ * the order they were contracted, and every vertex keeps the arcs
+ * to the vertexes of higher rank, either the edges of the graph, or
+ * the shortcuts added when the vertexes between were contracted.
+ *
+ * The vertexes of the core, which were not contracted, share the
+ * highest rank, and keep their arcs to each other both ways.
+ *
+ * The arcs of vertex v are from offsets[v] to offsets[v + 1] of
+ * targets, weights and middles, sorted by the target.  The middle of
+ * a shortcut is the vertex it skips, whose arcs lead to both ends of
+ * the shortcut; the middle of an edge is none.
+ */
+struct ch_set
+{
+  // The checksum of the graph.
+  std::uint64_t checksum = 0;
+
+  std::vector<std::uint32_t> ranks;
+  std::vector<std::uint64_t> offsets = {0};
+  std::vector<std::uint32_t> targets;
+  std::vector<COST> weights;
+  std::vector<std::uint32_t> middles;
+
+  /// The middle of an edge.
+  static constexpr std::uint32_t none = UINT32_MAX;
+};
+
+/**
+ * The header of the contraction hierarchy format.  The file is made
+ * of the header and the sections:
+ *
+ * - the ranks: nr_vertices numbers of uint32_t,
+ *
+ * - the offsets: nr_vertices + 1 numbers of uint64_t,
+ *
+ * - the targets: nr_arcs numbers of uint32_t,
+ *
+ * - the weights: nr_arcs numbers of double,
+ *
+ * - the middles: nr_arcs numbers of uint32_t.
+ *
+ * Like in the binary graph format, the numbers are in the byte order
+ * of the writer, and every section starts at a multiple of 8 bytes,
+ * so that a mapped file can be used in place.
+ */
+struct ch_header
+{
+  // The magic number, "NGCH" followed by four zeros.
+  char magic[8];
+  // The version of the format.
+  std::uint32_t version;
+  // The number 0x01020304 as written by the writer.
+  std::uint32_t byte_order;
+
+  std::uint64_t nr_vertices;
+  std::uint64_t nr_arcs;
+
+  // The checksum of the graph of the hierarchy.
+  std::uint64_t checksum;
+
+  // The positions of the sections in the file.
+  std::uint64_t ranks;
+  std::uint64_t offsets;
+  std::uint64_t targets;
+  std::uint64_t weights;
+  std::uint64_t middles;
+
+  // The size of the file.
+  std::uint64_t size;
+};
+
+// The version of the contraction hierarchy format written.
+constexpr std::uint32_t ch_version = 2;
+
+/**
+ * Write the contraction hierarchy in its format.
+ */
+void
+write_ch(out_buffer &out, const ch_set &s);
+
+/**
+ * The contraction hierarchy mapped into memory.  Nothing is copied,
+ * and the file stays mapped for as long as the table lives.
+ */
+class ch_table
+{
+public:
+  typedef csr_graph::vertex_type vertex_type;
+
+  /// Map the file, and check the arcs in a linear pass: they have to
+  /// be sorted, lead up the hierarchy, and a shortcut has to skip a
+  /// vertex of lower rank with the arcs to both its ends.  Throws
+  /// std::runtime_error if the file cannot be mapped or is not valid.
+  explicit ch_table(const std::string &path);
+
+  vertex_type
+  nr_vertices() const
+  {
+    return m_h->nr_vertices;
+  }
+
+  std::uint64_t
+  nr_arcs() const
+  {
+    return m_h->nr_arcs;
+  }
+
+  /// The checksum of the graph of the hierarchy.
+  std::uint64_t
+  checksum() const
+  {
+    return m_h->checksum;
+  }
+
+  std::uint32_t
+  rank(vertex_type v) const
+  {
+    return m_ranks[v];
+  }
+
+  /// The first arc of vertex v.
+  std::uint64_t
+  offset(vertex_type v) const
+  {
+    return m_offsets[v];
+  }
+
+  vertex_type
+  target(std::uint64_t a) const
+  {
+    return m_targets[a];
+  }
+
+  COST
+  weight(std::uint64_t a) const
+  {
+    return m_weights[a];
+  }
+
+  vertex_type
+  middle(std::uint64_t a) const
+  {
+    return m_middles[a];
+  }
+
+  /// The arc between u and v, which is an arc of the one of lower
+  /// rank, or of u in the core.  The arc has to exist.
+  std::uint64_t
+  arc(vertex_type u, vertex_type v) const;
+
+private:
+  // The arc between u and v as for arc(), or nr_arcs() if none.
+  std::uint64_t
+  find(vertex_type u, vertex_type v) const;
+
+  std::shared_ptr<const mapped_file> m_file;
+  const ch_header *m_h;
+  const std::uint32_t *m_ranks;
+  const std::uint64_t *m_offsets;
+  const std::uint32_t *m_targets;
+  const COST *m_weights;
+  const std::uint32_t *m_middles;
+};
+
+/**
+ * The shortest-path query on the contraction hierarchy: the
+ * bidirectional Dijkstra's search, where both searches go up the
+ * hierarchy only, and anywhere in the core.  Since the graph is
+ * undirected, the arcs of a vertex also lead down to it, which stalls
+ * the search at the vertex reached by a longer path than one from
+ * above ("stall on demand").  A thread should have one object, and
+ * run it for many queries.
+ */
+class ch_query
+{
+public:
+  typedef csr_graph::vertex_type vertex_type;
+
+  explicit ch_query(const ch_table &t);
+
+  /// Find the length of the shortest path from s to t, or infinity if
+  /// there is no path.
+  COST
+  distance(vertex_type s, vertex_type t);
+
+  /// The vertexes of the path found by the last query, from s to t,
+  /// with the shortcuts unpacked, or none if there is no path.
+  void
+  path(std::vector<vertex_type> &p) const;
+
+  /// The number of the vertexes settled by the last query.
+  std::uint32_t
+  settled() const
+  {
+    return m_settled;
+  }
+
+private:
+  // The label of a vertex reached by a search, valid if stamped with
+  // the number of the query.
+  struct label
+  {
+    COST dist;
+    std::uint32_t stamp = 0;
+    vertex_type pred;
+  };
+
+  // The search in one direction.
+  struct search
+  {
+    std::vector<label> labels;
+    std::vector<std::pair<COST, vertex_type>> heap;
+  };
+
+  // Settle the next vertex of search a, with the other search b.
+  void
+  step(search &a, const search &b);
+
+  const ch_table &m_t;
+  search m_s[2];
+  std::uint32_t m_time = 0;
+
+  vertex_type m_meet;
+  COST m_best;
+  std::uint32_t m_settled = 0;
+};
+
+#endif /* CH_TABLE_HPP */
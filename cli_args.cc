@@ -3,6 +3,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <boost/program_options.hpp>
 
@@ -10,6 +11,29 @@
 #define NT_S "nt"
 #define EDGES_S "edges"
 #define NODES_S "nodes"
+#define INPUT_S "input"
+#define BATCH_S "batch"
+#define ORDER_S "order"
+#define SURVIVABLE_S "survivable"
+#define REPLICAS_S "replicas"
+#define THREADS_S "threads"
+#define MODE_S "mode"
+#define ATTACK_S "attack"
+#define POINTS_S "points"
+#define SAMPLES_S "samples"
+#define QUERIES_S "queries"
+#define STATS_FORMAT_S "stats-format"
+#define PER_REPLICA_S "per-replica"
+#define BARE_IDS_S "bare-ids"
+#define FORMAT_S "format"
+#define BIN_NAMES_S "bin-names"
+#define STREAM_S "stream"
+#define GZIP_S "gzip"
+#define PATHS_S "paths"
+#define K_PATHS_S "k-paths"
+#define PAIRS_S "pairs"
+#define ROUTES_S "routes"
+#define CH_S "ch"
 
 using namespace std;
 namespace po = boost::program_options;
@@ -61,23 +85,117 @@ process_cli_args(int argc, const char *argv[])
       // Network options.
       po::options_description net("Network options");
       net.add_options()
-        (NT_S, po::value<string>()->required(),
+        (NT_S, po::value<string>(),
          "the network type")
 
         (NODES_S, po::value<int>(),
          "the number of nodes to generate")
 
         (EDGES_S, po::value<int>(),
-         "the number of edges to generate");
+         "the number of edges to generate")
+
+        (INPUT_S, po::value<vector<string>>(),
+         "the graph file (bin, DOT or edge list) to analyse instead "
+         "of a generated graph; can be repeated")
+
+        (BATCH_S, po::value<string>(),
+         "the batch file with the grid of the networks to generate")
+
+        (ORDER_S, po::value<string>()->default_value("none"),
+         "renumber the vertexes in the order: none, hilbert (of the "
+         "locations), rcm (reverse Cuthill-McKee) or degree")
+
+        (SURVIVABLE_S, po::value<string>()->default_value("none"),
+         "add the links to make the generated network survive a "
+         "failure: none, 2-edge (of any link) or 2-vertex (of any "
+         "node)");
 
       // Some other options.
       po::options_description soo("Simulation options");
       soo.add_options()
         ("seed", po::value<int>()->default_value(1),
-         "the seed of the random number generator");
+         "the seed of the random number generator")
+
+        (REPLICAS_S, po::value<int>()->default_value(100),
+         "the number of replicas to generate and analyse")
+
+        (THREADS_S, po::value<int>()->default_value(0),
+         "the number of threads, 0 for the number of hardware threads");
+
+      // Analysis options.
+      po::options_description ana("Analysis options");
+      ana.add_options()
+        (MODE_S, po::value<string>()->default_value("stats"),
+         "the analysis: stats, percolation (the largest component "
+         "as the nodes or links fail), betweenness (the node and "
+         "link loads of the shortest-path routing), diameter (the "
+         "diameter and the radius in hops and length), eccentricity "
+         "(the eccentricities of the nodes too), clustering (the "
+         "triangles and the clustering coefficients), spectrum (the "
+         "algebraic connectivity and the spectral radius), cuts "
+         "(the bridges and the articulation points), or query (the "
+         "shortest paths between the given nodes)")
+
+        (ATTACK_S, po::value<string>()->default_value("random-nodes"),
+         "the percolation attack: random-nodes, degree-nodes, "
+         "random-links or degree-links")
+
+        (POINTS_S, po::value<int>()->default_value(20),
+         "the number of the points of the percolation curve")
+
+        (SAMPLES_S, po::value<int>()->default_value(0),
+         "the number of the sources sampled for the betweenness, "
+         "0 for all")
+
+        (QUERIES_S, po::value<string>()->default_value("-"),
+         "the file with the query node pairs, a pair per line, or - for "
+         "the standard input")
+
+        (STATS_FORMAT_S, po::value<string>()->default_value("text"),
+         "the format of the statistics: text, or json (an object with "
+         "the statistics per line)")
+
+        (PER_REPLICA_S, "print the statistics of every replica as it "
+         "finishes, with the times of its generation and analysis, "
+         "before the statistics of the ensemble");
+
+      // Output options.
+      po::options_description out("Output options");
+      out.add_options()
+        (BARE_IDS_S, "name the vertexes with bare numbers from 0")
+
+        (FORMAT_S, po::value<string>()->default_value("dot"),
+         "the output format: dot, bin, edges, metis or graphml")
+
+        (BIN_NAMES_S, "store the vertex names in the bin format")
+
+        (GZIP_S, "compress the output with gzip")
+
+        (STREAM_S, "write the edges as they are generated, without "
+         "storing the graph (the random network in the text formats "
+         "except metis only)")
+
+        (PATHS_S, po::value<string>(),
+         "write the table of the k shortest paths and the shortest "
+         "edge-disjoint pair of paths of the node pairs to the file")
+
+        (K_PATHS_S, po::value<int>()->default_value(3),
+         "the number of the shortest paths of a node pair in the table")
+
+        (PAIRS_S, po::value<int>()->default_value(0),
+         "the number of the node pairs sampled for the table, 0 for all")
+
+        (ROUTES_S, po::value<string>(),
+         "write the next-hop tables of the shortest-path routing, "
+         "compressed, to the file")
+
+        (CH_S, po::value<string>(),
+         "write the contraction hierarchy of the graph to the file, or "
+         "in the query mode answer the queries with the hierarchy from "
+         "the file");
 
       po::options_description all("Allowed options");
-      all.add(gen).add(net).add(soo);
+      all.add(gen).add(net).add(soo).add(ana).add(out);
       
       po::variables_map vm;
       po::store(po::command_line_parser(argc, argv).options(all).run(), vm);
@@ -96,15 +214,81 @@ process_cli_args(int argc, const char *argv[])
       // notified automatically and the program will exit.
       po::notify(vm);
 
+      if (!vm.count(NT_S) && !vm.count(INPUT_S) && !vm.count(BATCH_S))
+        throw logic_error ("Option '" NT_S "', '" INPUT_S "' or '"
+                           BATCH_S "' is required.");
+
       // The network options.
-      result.nt = vm[NT_S].as<string>();
-      result.nr_nodes = vm[NODES_S].as<int>();
+      if (vm.count(NT_S))
+        {
+          result.nt = vm[NT_S].as<string>();
+          result.nr_nodes = vm[NODES_S].as<int>();
+        }
+
+      if (vm.count(INPUT_S))
+        result.inputs = vm[INPUT_S].as<vector<string>>();
+
+      if (vm.count(BATCH_S))
+        result.batch = vm[BATCH_S].as<string>();
+
+      result.order = vm[ORDER_S].as<string>();
+      result.survivable = vm[SURVIVABLE_S].as<string>();
 
       if (vm.count(EDGES_S))
         result.nr_edges = vm[EDGES_S].as<int>();
       
       // The simulation options.
       result.seed = vm["seed"].as<int>();
+      result.replicas = vm[REPLICAS_S].as<int>();
+      result.threads = vm[THREADS_S].as<int>();
+
+      // The analysis options.
+      result.mode = vm[MODE_S].as<string>();
+      result.attack = vm[ATTACK_S].as<string>();
+      result.points = vm[POINTS_S].as<int>();
+      result.samples = vm[SAMPLES_S].as<int>();
+      result.queries = vm[QUERIES_S].as<string>();
+      result.stats_format = vm[STATS_FORMAT_S].as<string>();
+      result.per_replica = vm.count(PER_REPLICA_S);
+
+      // The output options.
+      result.bare_ids = vm.count(BARE_IDS_S);
+      result.format = vm[FORMAT_S].as<string>();
+      result.bin_names = vm.count(BIN_NAMES_S);
+      result.stream = vm.count(STREAM_S);
+      result.gzip = vm.count(GZIP_S);
+      if (vm.count(PATHS_S))
+        result.paths = vm[PATHS_S].as<string>();
+      result.k_paths = vm[K_PATHS_S].as<int>();
+      result.pairs = vm[PAIRS_S].as<int>();
+      if (vm.count(ROUTES_S))
+        result.routes = vm[ROUTES_S].as<string>();
+      if (vm.count(CH_S))
+        result.ch = vm[CH_S].as<string>();
+
+      if (result.replicas < 1)
+        throw logic_error ("Option '" REPLICAS_S "' has to be positive.");
+      if (result.threads < 0)
+        throw logic_error ("Option '" THREADS_S "' cannot be negative.");
+      if (result.points < 1)
+        throw logic_error ("Option '" POINTS_S "' has to be positive.");
+      if (result.samples < 0)
+        throw logic_error ("Option '" SAMPLES_S "' cannot be negative.");
+      if (result.k_paths < 1)
+        throw logic_error ("Option '" K_PATHS_S "' has to be positive.");
+      if (result.pairs < 0)
+        throw logic_error ("Option '" PAIRS_S "' cannot be negative.");
+
+      // The streamed random network has to be connected and without
+      // parallel edges.
+      if (result.stream && !result.nt.empty() && result.nr_edges)
+        {
+          long long n = result.nr_nodes, e = result.nr_edges.get();
+          if (e < n - 1 || e > n * (n - 1) / 2)
+            throw logic_error ("Cannot connect " + to_string(n)
+                               + " nodes with " + to_string(e)
+                               + " edges.");
+        }
     }
   catch(const std::exception& e)
     {
@@ -2,6 +2,7 @@
 #define CLI_ARGS_HPP
 
 #include <string>
+#include <vector>
 #include <boost/optional.hpp>
 
 using namespace std;
@@ -9,6 +10,25 @@ using namespace std;
 // The network type.
 enum class nt_t {random_network, gabriel_network};
 
+// The output format.
+enum class format_t {dot, bin, edges, metis, graphml};
+
+// The vertex order.
+enum class order_t {none, hilbert, rcm, degree};
+
+// The analysis of info.
+enum class analysis_t {stats, percolation, betweenness, diameter,
+                        eccentricity, clustering, spectrum, cuts, query};
+
+// The connectivity the generated network is augmented to.
+enum class survivable_t {none, edge, vertex};
+
+// The attack of the percolation.
+enum class attack_t {random_nodes, degree_nodes, random_links, degree_links};
+
+// The format of the statistics of info.
+enum class stats_format_t {text, json};
+
 /**
  * These are the program arguments.  In this single class we store all
  * information passed at the command line.
@@ -23,13 +43,93 @@ struct cli_args
   std::string nt;
 
   /// The number of nodes in the graph.
-  int nr_nodes;
+  int nr_nodes = 0;
 
   /// The number of edges in the graph.
   boost::optional<int> nr_edges;
 
+  /// The graph files to analyse instead of the generated graphs.
+  std::vector<std::string> inputs;
+
+  /// The order to renumber the vertexes in.
+  std::string order;
+
+  /// The batch file with the grid of the networks to generate.
+  std::string batch;
+
+  /// The connectivity to augment the generated network to.
+  std::string survivable;
+
   /// The seed.
   int seed;
+
+  /// The number of replicas (the graphs generated and analysed).
+  int replicas;
+
+  /// The number of threads, or 0 for the number of hardware threads.
+  int threads;
+
+  /// -----------------------------------------------------------------
+  /// The analysis options
+  /// -----------------------------------------------------------------
+
+  /// The analysis of info.
+  std::string mode;
+
+  /// The attack of the percolation.
+  std::string attack;
+
+  /// The number of the points of the percolation curve.
+  int points;
+
+  /// The number of the sampled sources of the betweenness, or 0 for
+  /// all the nodes.
+  int samples;
+
+  /// The file with the queries, or "-" for the standard input.
+  std::string queries;
+
+  /// The format of the statistics.
+  std::string stats_format;
+
+  /// Print the statistics of every replica too.
+  bool per_replica;
+
+  /// -----------------------------------------------------------------
+  /// The output options
+  /// -----------------------------------------------------------------
+
+  /// Name the vertexes with the bare numbers (from 0).
+  bool bare_ids;
+
+  /// The output format.
+  std::string format;
+
+  /// Store the vertex names in the binary format.
+  bool bin_names;
+
+  /// Compress the output with gzip.
+  bool gzip;
+
+  /// Write the edges as they are generated.
+  bool stream;
+
+  /// The file to write the path table to, if not empty.
+  std::string paths;
+
+  /// The number of the shortest paths of a node pair in the table.
+  int k_paths;
+
+  /// The number of the node pairs sampled for the table, or 0 for
+  /// all the pairs.
+  int pairs;
+
+  /// The file to write the route table to, if not empty.
+  std::string routes;
+
+  /// The file of the contraction hierarchy, if not empty: netgen
+  /// writes the hierarchy to it, and the query mode reads it.
+  std::string ch;
 };
 
 /**
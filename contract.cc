@@ -0,0 +1,368 @@
+#include "contract.hpp"
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+typedef csr_graph::vertex_type vertex_type;
+
+static const COST infinity = numeric_limits<COST>::infinity();
+
+// The number of the vertexes a witness search settles at most, when
+// a vertex is contracted, and when its priority is estimated.
+static const uint32_t contract_limit = 500;
+static const uint32_t estimate_limit = 50;
+
+namespace
+{
+  // The arc of the remaining graph, to a vertex not contracted yet.
+  struct arc
+  {
+    vertex_type to;
+    vertex_type middle;
+    COST w;
+  };
+
+  // The shortcut between a and b over middle.
+  struct shortcut
+  {
+    vertex_type a;
+    vertex_type b;
+    vertex_type middle;
+    COST w;
+  };
+
+  typedef vector<vector<arc>> adjacency;
+
+  /**
+   * The witness search: Dijkstra's search in the remaining graph that
+   * avoids the given vertexes, and stops when it has settled all its
+   * targets, or gives up past the distance limit or after settling
+   * the given number of vertexes.  The vertexes are stamped with the
+   * number of the search, so that a search doesn't have to clear the
+   * arrays.
+   */
+  class witness
+  {
+  public:
+    explicit witness(vertex_type n):
+      m_dist(n), m_stamp(n, 0), m_target(n, 0)
+    {
+    }
+
+    // Make v a target of the next search.
+    void
+    target(vertex_type v)
+    {
+      if (m_target[v] != m_time + 1)
+        {
+          m_target[v] = m_time + 1;
+          ++m_targets;
+        }
+    }
+
+    template <typename A>
+    void
+    run(const adjacency &adj, vertex_type s, A avoid, COST limit,
+        uint32_t max_settled)
+    {
+      // Start over when the stamps run out, keeping the targets.
+      if (++m_time == UINT32_MAX)
+        {
+          fill(m_stamp.begin(), m_stamp.end(), 0);
+          for (uint32_t &t: m_target)
+            t = t == m_time;
+          m_time = 1;
+        }
+
+      greater<pair<COST, vertex_type>> cmp;
+      m_heap.clear();
+      m_stamp[s] = m_time;
+      m_dist[s] = 0;
+      m_heap.emplace_back(0, s);
+
+      uint32_t left = m_targets;
+      m_targets = 0;
+
+      for (uint32_t settled = 0; !m_heap.empty() && left &&
+             settled < max_settled; )
+        {
+          pop_heap(m_heap.begin(), m_heap.end(), cmp);
+          auto [d, u] = m_heap.back();
+          m_heap.pop_back();
+
+          if (d > m_dist[u])
+            continue;
+          if (d > limit)
+            break;
+          ++settled;
+          left -= m_target[u] == m_time;
+
+          for (const arc &e: adj[u])
+            {
+              if (avoid(e.to))
+                continue;
+
+              COST nd = d + e.w;
+              if (m_stamp[e.to] != m_time || nd < m_dist[e.to])
+                {
+                  m_stamp[e.to] = m_time;
+                  m_dist[e.to] = nd;
+                  m_heap.emplace_back(nd, e.to);
+                  push_heap(m_heap.begin(), m_heap.end(), cmp);
+                }
+            }
+        }
+    }
+
+    // The distance found, or infinity.
+    COST
+    dist(vertex_type v) const
+    {
+      return m_stamp[v] == m_time ? m_dist[v] : infinity;
+    }
+
+  private:
+    vector<COST> m_dist;
+    vector<uint32_t> m_stamp;
+    vector<uint32_t> m_target;
+    uint32_t m_time = 0;
+    uint32_t m_targets = 0;
+    vector<pair<COST, vertex_type>> m_heap;
+  };
+
+  /**
+   * Find the shortcuts of contracting v, and return their number.
+   * The shortcuts are appended to out, if given, and otherwise their
+   * number is only estimated with the shorter witness searches.
+   */
+  template <typename A>
+  size_t
+  shortcuts(const adjacency &adj, vertex_type v, witness &ws, A avoid,
+            vector<shortcut> *out)
+  {
+    const vector<arc> &nv = adj[v];
+    size_t r = 0;
+
+    for (size_t i = 0; i + 1 < nv.size(); ++i)
+      {
+        COST limit = 0;
+        for (size_t j = i + 1; j < nv.size(); ++j)
+          {
+            ws.target(nv[j].to);
+            limit = max(limit, nv[i].w + nv[j].w);
+          }
+        ws.run(adj, nv[i].to, avoid, limit,
+               out ? contract_limit : estimate_limit);
+
+        for (size_t j = i + 1; j < nv.size(); ++j)
+          {
+            COST w = nv[i].w + nv[j].w;
+            if (ws.dist(nv[j].to) > w)
+              {
+                ++r;
+                if (out)
+                  out->push_back({nv[i].to, nv[j].to, v, w});
+              }
+          }
+      }
+
+    return r;
+  }
+
+  // Add the arc to b, or make the arc shorter.  Returns true if the
+  // arc was added.
+  bool
+  add_arc(vector<arc> &a, vertex_type b, vertex_type middle, COST w)
+  {
+    for (arc &e: a)
+      if (e.to == b)
+        {
+          if (w < e.w)
+            {
+              e.w = w;
+              e.middle = middle;
+            }
+          return false;
+        }
+
+    a.push_back({b, middle, w});
+    return true;
+  }
+
+  // Mix the bits of the vertex number, to break the ties of the
+  // priorities without favouring the low numbers.
+  uint32_t
+  mix(uint32_t x)
+  {
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+  }
+}
+
+ch_set
+contract(const csr_graph &g, unsigned threads)
+{
+  vertex_type n = g.nr_vertices();
+  threads = min<size_t>(nr_threads(threads), max<size_t>(n, 1));
+
+  // The remaining graph, and the number of its arcs.  The contraction
+  // stops when the remaining graph has more arcs than the graph, and
+  // the remaining vertexes are left as the core.
+  adjacency adj(n);
+  uint64_t arcs = 0;
+  for (vertex_type v = 0; v < n; ++v)
+    for (auto a = g.offset(v); a < g.offset(v + 1); ++a)
+      if (g.targets()[a] != v)
+        arcs += add_arc(adj[v], g.targets()[a], ch_set::none,
+                        g.weights()[a]);
+
+  // The priorities, which go stale when a neighbour is contracted.
+  vector<int64_t> priority(n);
+  vector<uint32_t> deleted(n, 0), level(n, 0);
+  vector<char> stale(n, false);
+  vector<bool> contracted(n, false);
+
+  // The vertexes of the round.
+  vector<uint32_t> round(n, 0);
+  uint32_t time = 0;
+
+  vector<witness> ws(threads, witness(n));
+
+  auto update = [&](const vector<vertex_type> &vs)
+    {
+      parallel_for(vs.size(), threads, [&](size_t i, unsigned t)
+        {
+          vertex_type v = vs[i];
+          int64_t s = shortcuts(adj, v, ws[t], [v](vertex_type u)
+                                {return u == v;}, nullptr);
+          priority[v] = s - int64_t(adj[v].size()) + deleted[v] + level[v];
+          stale[v] = false;
+        });
+    };
+
+  // The priority of v is lower than those of its neighbours.
+  auto minimum = [&](vertex_type v)
+    {
+      auto p = make_pair(priority[v], mix(v));
+      return all_of(adj[v].begin(), adj[v].end(), [&](const arc &e)
+                    {return p < make_pair(priority[e.to], mix(e.to));});
+    };
+
+  vector<vertex_type> remaining(n);
+  for (vertex_type v = 0; v < n; ++v)
+    remaining[v] = v;
+  update(remaining);
+
+  ch_set r;
+  r.checksum = checksum(g);
+  r.ranks.assign(n, 0);
+  vector<vector<arc>> up(n);
+  uint32_t rank = 0;
+
+  uint64_t graph_arcs = arcs;
+  vector<vertex_type> candidates, selected, fresh;
+  vector<vector<shortcut>> added;
+
+  while (!remaining.empty() && arcs <= graph_arcs)
+    {
+      // The candidates are of lower priority than their neighbours.
+      // They are contracted unless their stale priorities are no
+      // longer lower once updated.
+      candidates.clear();
+      fresh.clear();
+      for (vertex_type v: remaining)
+        if (minimum(v))
+          {
+            candidates.push_back(v);
+            if (stale[v])
+              fresh.push_back(v);
+          }
+      update(fresh);
+
+      ++time;
+      selected.clear();
+      for (vertex_type v: candidates)
+        if (minimum(v))
+          {
+            selected.push_back(v);
+            round[v] = time;
+          }
+
+      // Their shortcuts, found in parallel.
+      added.assign(selected.size(), vector<shortcut>());
+      parallel_for(selected.size(), threads, [&](size_t i, unsigned t)
+        {
+          shortcuts(adj, selected[i], ws[t], [&](vertex_type u)
+                    {return round[u] == time;}, &added[i]);
+        });
+
+      // Contract them: their arcs go up, to the remaining vertexes.
+      for (vertex_type v: selected)
+        {
+          r.ranks[v] = rank++;
+          contracted[v] = true;
+          arcs -= 2 * adj[v].size();
+          for (const arc &e: adj[v])
+            {
+              vector<arc> &a = adj[e.to];
+              a.erase(find_if(a.begin(), a.end(), [v](const arc &x)
+                              {return x.to == v;}));
+
+              // The cheap terms of the priority are kept up to date.
+              uint32_t l = max(level[e.to], level[v] + 1);
+              priority[e.to] += 1 + l - level[e.to];
+              ++deleted[e.to];
+              level[e.to] = l;
+              stale[e.to] = true;
+            }
+          up[v] = move(adj[v]);
+          adj[v] = vector<arc>();
+        }
+
+      for (const auto &a: added)
+        for (const shortcut &s: a)
+          {
+            arcs += add_arc(adj[s.a], s.b, s.middle, s.w);
+            arcs += add_arc(adj[s.b], s.a, s.middle, s.w);
+          }
+
+      remaining.erase(remove_if(remaining.begin(), remaining.end(),
+                                [&](vertex_type v) {return contracted[v];}),
+                      remaining.end());
+    }
+
+  // The core shares the highest rank, and keeps its arcs both ways.
+  for (vertex_type v: remaining)
+    {
+      r.ranks[v] = rank;
+      up[v] = move(adj[v]);
+    }
+
+  // The arcs of every vertex, sorted by the target.
+  for (vertex_type v = 0; v < n; ++v)
+    {
+      sort(up[v].begin(), up[v].end(), [](const arc &a, const arc &b)
+           {return a.to < b.to;});
+      for (const arc &e: up[v])
+        {
+          r.targets.push_back(e.to);
+          r.weights.push_back(e.w);
+          r.middles.push_back(e.middle);
+        }
+      r.offsets.push_back(r.targets.size());
+      vector<arc>().swap(up[v]);
+    }
+
+  return r;
+}
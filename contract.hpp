@@ -0,0 +1,36 @@
+#ifndef CONTRACT_HPP
+#define CONTRACT_HPP
+
+#include "ch_table.hpp"
+#include "csr_graph.hpp"
+
+/**
+ * Build the contraction hierarchy of the graph.  The vertexes are
+ * contracted in rounds: a round takes the vertexes whose priority is
+ * lower than that of their remaining neighbours, and contracts them
+ * in parallel on the given number of threads.  Contracting a vertex
+ * adds a shortcut between two of its neighbours, unless the witness
+ * search finds a path between them that is not longer and avoids
+ * the vertex.  The witness searches avoid all the vertexes of the
+ * round, so that the shortcuts of one vertex don't count on the
+ * paths through another.
+ *
+ * The priority of a vertex is the number of its shortcuts less its
+ * degree, plus the number of its neighbours contracted, plus its
+ * level (the depth of the hierarchy below it), so that the graph
+ * shrinks, and the contracted vertexes spread evenly.  The number of
+ * the shortcuts is estimated with shorter witness searches, and only
+ * again when the vertex is about to be contracted after one of its
+ * neighbours was.
+ *
+ * The witness searches are limited, so a shortcut can be added that
+ * isn't needed, but the distances are always kept.  The contraction
+ * stops when the remaining graph gets more arcs than the graph, which
+ * happens for the graphs without a hierarchy, like the random ones,
+ * and the remaining vertexes are left as the core.  The hierarchy
+ * doesn't depend on the number of threads.
+ */
+ch_set
+contract(const csr_graph &g, unsigned threads);
+
+#endif /* CONTRACT_HPP */
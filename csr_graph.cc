@@ -0,0 +1,174 @@
+#include "csr_graph.hpp"
+
+#include <boost/range.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace std;
+
+csr_graph::csr_graph(vector<uint64_t> offsets, vector<uint32_t> targets,
+                     vector<COST> weights, vector<location> locations)
+{
+  // The owner of the vectors.
+  struct storage
+  {
+    vector<uint64_t> offsets;
+    vector<uint32_t> targets;
+    vector<COST> weights;
+    vector<location> locations;
+  };
+
+  auto s = make_shared<storage>();
+  s->offsets = move(offsets);
+  s->targets = move(targets);
+  s->weights = move(weights);
+  s->locations = move(locations);
+
+  assert(!s->offsets.empty());
+  assert(s->targets.size() == s->weights.size());
+  assert(s->locations.empty() ||
+         s->locations.size() + 1 == s->offsets.size());
+
+  arrays a;
+  a.offsets = s->offsets.data();
+  a.targets = s->targets.data();
+  a.weights = s->weights.data();
+  if (!s->locations.empty())
+    a.locations = s->locations.data();
+
+  *this = csr_graph(s->offsets.size() - 1, s->targets.size(), a, s);
+}
+
+csr_graph
+csr_builder::build()
+{
+  typedef csr_graph::vertex_type vertex_type;
+
+  // The number of arcs with the given target.  The counters are then
+  // turned into the positions, where the arcs go.
+  // The self-loops are skipped.
+  vector<uint64_t> count(m_n + 1, 0);
+  for (const auto &e: m_edges)
+    {
+      assert(get<0>(e) < m_n && get<1>(e) < m_n);
+      if (get<0>(e) != get<1>(e))
+        {
+          ++count[get<0>(e) + 1];
+          ++count[get<1>(e) + 1];
+        }
+    }
+  for (vertex_type v = 0; v < m_n; ++v)
+    count[v + 1] += count[v];
+
+  // The first pass: sort the arcs by target.
+  m_arcs.resize(count[m_n]);
+  for (const auto &e: m_edges)
+    {
+      vertex_type u = get<0>(e), v = get<1>(e);
+      if (u == v)
+        continue;
+      m_arcs[count[v]++] = make_tuple(u, v, get<2>(e));
+      m_arcs[count[u]++] = make_tuple(v, u, get<2>(e));
+    }
+
+  // The second pass: a stable sort of the arcs by source.  Since the
+  // graph is symmetric, a vertex has as many arcs leaving as
+  // entering, so the counters computed above give the offsets.
+  vector<uint64_t> offsets(m_n + 1, 0);
+  for (vertex_type v = 0; v < m_n; ++v)
+    offsets[v + 1] = count[v];
+  count.assign(offsets.begin(), offsets.end());
+
+  vector<uint32_t> targets(m_arcs.size());
+  vector<COST> weights(m_arcs.size());
+  for (const auto &a: m_arcs)
+    {
+      uint64_t i = count[get<0>(a)]++;
+      targets[i] = get<1>(a);
+      weights[i] = get<2>(a);
+    }
+
+  // The parallel arcs are next to each other now, and are merged into
+  // the first one, with the smallest weight.
+  uint64_t j = 0;
+  for (vertex_type v = 0; v < m_n; ++v)
+    {
+      uint64_t b = offsets[v], e = offsets[v + 1];
+      offsets[v] = j;
+      for (uint64_t i = b; i < e; ++i)
+        if (j > offsets[v] && targets[j - 1] == targets[i])
+          weights[j - 1] = min(weights[j - 1], weights[i]);
+        else
+          {
+            targets[j] = targets[i];
+            weights[j] = weights[i];
+            ++j;
+          }
+    }
+  offsets[m_n] = j;
+  targets.resize(j);
+  weights.resize(j);
+
+  return csr_graph(move(offsets), move(targets), move(weights),
+                   move(m_locations));
+}
+
+uint64_t
+checksum(const csr_graph &g)
+{
+  // FNV-1a over the numbers, each mixed first (splitmix64), so that
+  // all their bits count.
+  uint64_t h = 0xcbf29ce484222325;
+  auto add = [&h](uint64_t x)
+    {
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+      h = (h ^ x ^ (x >> 31)) * 0x100000001b3;
+    };
+
+  add(g.nr_vertices());
+  for (csr_graph::vertex_type v = 0; v < g.nr_vertices(); ++v)
+    {
+      add(g.offset(v + 1));
+      for (auto a = g.offset(v); a < g.offset(v + 1); ++a)
+        {
+          uint64_t w;
+          static_assert(sizeof(w) == sizeof(COST));
+          memcpy(&w, &g.weights()[a], sizeof(w));
+          add(g.targets()[a]);
+          add(w);
+        }
+    }
+
+  return h;
+}
+
+csr_graph
+make_csr(const graph &g)
+{
+  csr_builder b;
+  return make_csr(g, b);
+}
+
+csr_graph
+make_csr(const graph &g, csr_builder &b)
+{
+  b.reset(num_vertices(g));
+
+  for (edge e: boost::make_iterator_range(edges(g)))
+    b.add_edge(source(e, g), target(e, g),
+               boost::get(boost::edge_weight, g, e));
+
+  if (g[boost::graph_bundle].located)
+    {
+      vector<location> l;
+      l.reserve(num_vertices(g));
+      for (vertex v: boost::make_iterator_range(vertices(g)))
+        l.push_back(g[v]);
+      b.set_locations(move(l));
+    }
+
+  return b.build();
+}
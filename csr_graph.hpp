@@ -0,0 +1,422 @@
+#ifndef CSR_GRAPH_HPP
+#define CSR_GRAPH_HPP
+
+#include "graph.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/property_map/property_map.hpp>
+
+/**
+ * The arc of the CSR graph: the source vertex, and the index of the
+ * arc in the target and the weight arrays.
+ */
+struct csr_arc
+{
+  std::uint32_t src;
+  std::uint64_t idx;
+
+  bool
+  operator==(const csr_arc &a) const
+  {
+    return idx == a.idx;
+  }
+
+  bool
+  operator!=(const csr_arc &a) const
+  {
+    return idx != a.idx;
+  }
+};
+
+/**
+ * The immutable graph in the compressed sparse row format.  The
+ * vertexes are numbered from 0 with 32-bit numbers.  The arcs leaving
+ * vertex v are at positions from offset(v) to offset(v + 1) of the
+ * target and the weight arrays, sorted by the target.  An undirected
+ * edge is stored as two arcs, one in each direction.  Optionally, the
+ * graph has the vertex locations and the vertex names.
+ *
+ * The graph is a read-only view of the arrays, which are kept alive
+ * by a shared owner: either the vectors the graph was built from, or
+ * a memory-mapped file.  Copying the graph doesn't copy the arrays.
+ *
+ * The graph models the Boost VertexListGraph and IncidenceGraph
+ * concepts as a symmetric directed graph, and provides the
+ * vertex_index and edge_weight property maps, so that the Boost
+ * algorithms (like dijkstra_shortest_paths) can run on it.
+ */
+class csr_graph
+{
+public:
+  typedef std::uint32_t vertex_type;
+
+  /// The arrays of the graph.  The optional ones can be null.
+  struct arrays
+  {
+    const std::uint64_t *offsets = nullptr;
+    const std::uint32_t *targets = nullptr;
+    const COST *weights = nullptr;
+    const location *locations = nullptr;
+    // The name of vertex v is at name_offsets[v] of names, and ends
+    // at name_offsets[v + 1].
+    const std::uint64_t *name_offsets = nullptr;
+    const char *names = nullptr;
+  };
+
+  csr_graph() = default;
+
+  /// The view of the arrays kept alive by the owner.
+  csr_graph(vertex_type n, std::uint64_t nr_arcs, const arrays &a,
+            std::shared_ptr<const void> owner):
+    m_n(n), m_nr_arcs(nr_arcs), m_a(a), m_owner(std::move(owner))
+  {
+  }
+
+  /// The graph that owns the vectors.
+  csr_graph(std::vector<std::uint64_t> offsets,
+            std::vector<std::uint32_t> targets,
+            std::vector<COST> weights,
+            std::vector<location> locations = {});
+
+  /// The number of vertexes.
+  vertex_type
+  nr_vertices() const
+  {
+    return m_n;
+  }
+
+  /// The number of arcs, i.e., twice the number of edges.
+  std::uint64_t
+  nr_arcs() const
+  {
+    return m_nr_arcs;
+  }
+
+  /// The number of undirected edges.
+  std::uint64_t
+  nr_edges() const
+  {
+    return m_nr_arcs / 2;
+  }
+
+  /// The index of the first arc of vertex v.
+  std::uint64_t
+  offset(vertex_type v) const
+  {
+    return m_a.offsets[v];
+  }
+
+  std::uint32_t
+  degree(vertex_type v) const
+  {
+    return m_a.offsets[v + 1] - m_a.offsets[v];
+  }
+
+  const std::uint64_t *
+  offsets() const
+  {
+    return m_a.offsets;
+  }
+
+  const std::uint32_t *
+  targets() const
+  {
+    return m_a.targets;
+  }
+
+  const COST *
+  weights() const
+  {
+    return m_a.weights;
+  }
+
+  /// The vertex locations, or null.
+  const location *
+  locations() const
+  {
+    return m_a.locations;
+  }
+
+  bool
+  has_names() const
+  {
+    return m_a.names;
+  }
+
+  /// The stored name of vertex v.
+  std::pair<const char *, const char *>
+  name(vertex_type v) const
+  {
+    return std::make_pair(m_a.names + m_a.name_offsets[v],
+                          m_a.names + m_a.name_offsets[v + 1]);
+  }
+
+  /// The number of bytes taken by the arrays.
+  std::size_t
+  memory() const
+  {
+    return (m_n + 1) * sizeof(std::uint64_t) +
+      m_nr_arcs * (sizeof(std::uint32_t) + sizeof(COST)) +
+      (m_a.locations ? m_n * sizeof(location) : 0) +
+      (m_a.names ? (m_n + 1) * sizeof(std::uint64_t) +
+       m_a.name_offsets[m_n] : 0);
+  }
+
+  /// ---------------------------------------------------------------
+  /// The Boost graph types.
+  /// ---------------------------------------------------------------
+
+  struct traversal_category:
+    boost::incidence_graph_tag, boost::vertex_list_graph_tag
+  {
+  };
+
+  class out_edge_iterator:
+    public boost::iterator_facade<out_edge_iterator, csr_arc,
+                                  boost::random_access_traversal_tag,
+                                  csr_arc>
+  {
+    csr_arc m_arc;
+
+  public:
+    out_edge_iterator() = default;
+
+    out_edge_iterator(vertex_type src, std::uint64_t idx):
+      m_arc{src, idx}
+    {
+    }
+
+  private:
+    friend class boost::iterator_core_access;
+
+    csr_arc
+    dereference() const
+    {
+      return m_arc;
+    }
+
+    bool
+    equal(const out_edge_iterator &i) const
+    {
+      return m_arc.idx == i.m_arc.idx;
+    }
+
+    void
+    increment()
+    {
+      ++m_arc.idx;
+    }
+
+    void
+    decrement()
+    {
+      --m_arc.idx;
+    }
+
+    void
+    advance(std::ptrdiff_t n)
+    {
+      m_arc.idx += n;
+    }
+
+    std::ptrdiff_t
+    distance_to(const out_edge_iterator &i) const
+    {
+      return i.m_arc.idx - m_arc.idx;
+    }
+  };
+
+  typedef vertex_type vertex_descriptor;
+  typedef csr_arc edge_descriptor;
+  typedef boost::counting_iterator<vertex_type> vertex_iterator;
+  typedef boost::directed_tag directed_category;
+  typedef boost::disallow_parallel_edge_tag edge_parallel_category;
+  typedef vertex_type vertices_size_type;
+  typedef std::uint64_t edges_size_type;
+  typedef std::uint32_t degree_size_type;
+
+  static vertex_type
+  null_vertex()
+  {
+    return UINT32_MAX;
+  }
+
+private:
+  vertex_type m_n = 0;
+  std::uint64_t m_nr_arcs = 0;
+  arrays m_a;
+  std::shared_ptr<const void> m_owner;
+};
+
+/**
+ * The builder of the CSR graph.  The undirected edges are added in
+ * any order, and then the graph is built with a two-pass counting
+ * sort, so that the arcs of every vertex end up sorted by target.
+ * The graph is simple: the self-loops are dropped, and the parallel
+ * edges are merged into one with the smallest weight.  The vertex
+ * locations can be given too.
+ */
+class csr_builder
+{
+public:
+  explicit csr_builder(csr_graph::vertex_type n = 0):
+    m_n(n)
+  {
+  }
+
+  /// Forget the edges, but keep the memory for the next graph.
+  void
+  reset(csr_graph::vertex_type n)
+  {
+    m_n = n;
+    m_edges.clear();
+    m_locations.clear();
+  }
+
+  void
+  set_locations(std::vector<location> locations)
+  {
+    m_locations = std::move(locations);
+  }
+
+  void
+  add_edge(csr_graph::vertex_type u, csr_graph::vertex_type v, COST w)
+  {
+    m_edges.push_back(std::make_tuple(u, v, w));
+  }
+
+  csr_graph
+  build();
+
+private:
+  csr_graph::vertex_type m_n;
+  std::vector<location> m_locations;
+  std::vector<std::tuple<csr_graph::vertex_type,
+                         csr_graph::vertex_type, COST>> m_edges;
+  // The arcs sorted by target, kept between the builds.
+  std::vector<std::tuple<csr_graph::vertex_type,
+                         csr_graph::vertex_type, COST>> m_arcs;
+};
+
+/**
+ * Finalize the generated graph into the CSR graph.
+ */
+csr_graph
+make_csr(const graph &g);
+
+/**
+ * Finalize the generated graph with the given builder, whose memory
+ * is reused from graph to graph.
+ */
+csr_graph
+make_csr(const graph &g, csr_builder &b);
+
+/**
+ * The checksum of the graph: of its arcs, their targets and weights,
+ * in the order of the vertexes.  A file made for the graph, like its
+ * contraction hierarchy, keeps the checksum to tell the graph it is
+ * of.
+ */
+std::uint64_t
+checksum(const csr_graph &g);
+
+/// -----------------------------------------------------------------
+/// The Boost graph interface of the CSR graph.
+/// -----------------------------------------------------------------
+
+inline csr_graph::vertex_type
+num_vertices(const csr_graph &g)
+{
+  return g.nr_vertices();
+}
+
+inline std::pair<csr_graph::vertex_iterator, csr_graph::vertex_iterator>
+vertices(const csr_graph &g)
+{
+  return std::make_pair(csr_graph::vertex_iterator(0),
+                        csr_graph::vertex_iterator(g.nr_vertices()));
+}
+
+inline std::pair<csr_graph::out_edge_iterator, csr_graph::out_edge_iterator>
+out_edges(csr_graph::vertex_type v, const csr_graph &g)
+{
+  return std::make_pair(csr_graph::out_edge_iterator(v, g.offset(v)),
+                        csr_graph::out_edge_iterator(v, g.offset(v + 1)));
+}
+
+inline std::uint32_t
+out_degree(csr_graph::vertex_type v, const csr_graph &g)
+{
+  return g.degree(v);
+}
+
+inline csr_graph::vertex_type
+source(const csr_arc &a, const csr_graph &)
+{
+  return a.src;
+}
+
+inline csr_graph::vertex_type
+target(const csr_arc &a, const csr_graph &g)
+{
+  return g.targets()[a.idx];
+}
+
+/**
+ * The edge weight map of the CSR graph.
+ */
+struct csr_weight_map
+{
+  typedef csr_arc key_type;
+  typedef COST value_type;
+  typedef const COST &reference;
+  typedef boost::readable_property_map_tag category;
+
+  const COST *m_weights;
+};
+
+inline const COST &
+get(const csr_weight_map &m, const csr_arc &a)
+{
+  return m.m_weights[a.idx];
+}
+
+inline csr_weight_map
+get(boost::edge_weight_t, const csr_graph &g)
+{
+  return csr_weight_map{g.weights()};
+}
+
+inline boost::typed_identity_property_map<csr_graph::vertex_type>
+get(boost::vertex_index_t, const csr_graph &)
+{
+  return boost::typed_identity_property_map<csr_graph::vertex_type>();
+}
+
+namespace boost
+{
+  template <>
+  struct property_map<csr_graph, edge_weight_t>
+  {
+    typedef csr_weight_map type;
+    typedef csr_weight_map const_type;
+  };
+
+  template <>
+  struct property_map<csr_graph, vertex_index_t>
+  {
+    typedef typed_identity_property_map<csr_graph::vertex_type> type;
+    typedef type const_type;
+  };
+}
+
+#endif /* CSR_GRAPH_HPP */
@@ -0,0 +1,189 @@
+#ifndef CUTS_HPP
+#define CUTS_HPP
+
+#include <boost/graph/graph_traits.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * The cuts of a graph: the bridges, the articulation points, the
+ * 2-edge-connected components and the blocks (the 2-vertex-connected
+ * components).
+ */
+struct cut_result
+{
+  typedef std::uint32_t vertex_type;
+
+  /// The bridges, as the pairs of their vertexes.
+  std::vector<std::pair<vertex_type, vertex_type>> bridges;
+
+  /// The articulation points, in the increasing order.
+  std::vector<vertex_type> articulations;
+
+  /// The 2-edge-connected component of every vertex.
+  std::vector<vertex_type> component;
+
+  /// The number of the 2-edge-connected components.
+  vertex_type components = 0;
+
+  /// The vertexes of block b are at block_offsets[b] of
+  /// block_vertexes, and end at block_offsets[b + 1].  A vertex
+  /// without edges makes a block of its own.
+  std::vector<std::uint64_t> block_offsets = {0};
+  std::vector<vertex_type> block_vertexes;
+
+  /// The number of the blocks.
+  std::size_t
+  blocks() const
+  {
+    return block_offsets.size() - 1;
+  }
+};
+
+/**
+ * Find the cuts of the graph with the depth-first search of Tarjan,
+ * in O(n + m) time.  The search keeps its own stack, so that the
+ * depth of the graph is not limited by the stack of the thread.  The
+ * components and the blocks are numbered in the order they are
+ * completed, so the leaves of the bridge tree and of the block tree
+ * come in the depth-first order.  The graph has to be simple.
+ */
+template <typename G>
+cut_result
+find_cuts(const G &g)
+{
+  typedef cut_result::vertex_type vertex_type;
+  typedef typename boost::graph_traits<G>::out_edge_iterator iterator;
+
+  const vertex_type none = UINT32_MAX;
+  vertex_type n = num_vertices(g);
+
+  cut_result r;
+  r.component.assign(n, none);
+
+  // The discovery time, and the lowest discovery time reachable from
+  // the subtree with one back edge.
+  std::vector<vertex_type> disc(n, none);
+  std::vector<vertex_type> low(n);
+  std::vector<bool> articulation(n, false);
+
+  // The vertexes of the blocks and of the components being built.
+  std::vector<vertex_type> block_stack;
+  std::vector<vertex_type> component_stack;
+
+  // The frame of the search: the vertex, its parent, and the next
+  // edge to follow.
+  struct frame
+  {
+    vertex_type v;
+    vertex_type parent;
+    iterator i;
+    iterator end;
+    bool skipped;
+  };
+  std::vector<frame> stack;
+
+  vertex_type time = 0;
+
+  auto discover = [&](vertex_type v, vertex_type parent)
+    {
+      disc[v] = low[v] = time++;
+      block_stack.push_back(v);
+      component_stack.push_back(v);
+      auto p = out_edges(v, g);
+      stack.push_back(frame{v, parent, p.first, p.second, false});
+    };
+
+  for (vertex_type root = 0; root < n; ++root)
+    {
+      if (disc[root] != none)
+        continue;
+
+      discover(root, none);
+      vertex_type children = 0;
+
+      while (!stack.empty())
+        {
+          frame &f = stack.back();
+
+          if (f.i != f.end)
+            {
+              vertex_type w = target(*f.i, g);
+              ++f.i;
+
+              // Skip the edge to the parent once.
+              if (w == f.parent && !f.skipped)
+                f.skipped = true;
+              else if (disc[w] == none)
+                discover(w, f.v);
+              else
+                low[f.v] = std::min(low[f.v], disc[w]);
+
+              continue;
+            }
+
+          vertex_type v = f.v, p = f.parent;
+          stack.pop_back();
+
+          // The vertex heads a 2-edge-connected component.
+          if (low[v] == disc[v])
+            {
+              vertex_type w;
+              do
+                {
+                  w = component_stack.back();
+                  component_stack.pop_back();
+                  r.component[w] = r.components;
+                }
+              while (w != v);
+              ++r.components;
+            }
+
+          if (p == none)
+            continue;
+
+          low[p] = std::min(low[p], low[v]);
+
+          if (low[v] > disc[p])
+            r.bridges.push_back(std::make_pair(p, v));
+
+          // The subtree of v with p makes a block.
+          if (low[v] >= disc[p])
+            {
+              vertex_type w;
+              do
+                {
+                  w = block_stack.back();
+                  block_stack.pop_back();
+                  r.block_vertexes.push_back(w);
+                }
+              while (w != v);
+              r.block_vertexes.push_back(p);
+              r.block_offsets.push_back(r.block_vertexes.size());
+
+              if (p != root || ++children > 1)
+                articulation[p] = true;
+            }
+        }
+
+      // The root without edges.
+      if (!children)
+        {
+          r.block_vertexes.push_back(root);
+          r.block_offsets.push_back(r.block_vertexes.size());
+        }
+
+      block_stack.clear();
+    }
+
+  for (vertex_type v = 0; v < n; ++v)
+    if (articulation[v])
+      r.articulations.push_back(v);
+
+  return r;
+}
+
+#endif /* CUTS_HPP */
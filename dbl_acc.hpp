@@ -0,0 +1,91 @@
+#ifndef DBL_ACC_HPP
+#define DBL_ACC_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+/**
+ * The accumulator with double values.  It keeps the number of
+ * samples, the min, the max, the mean and the sum of squared
+ * deviations from the mean (updated with Welford's method), so that
+ * two accumulators can be merged (with Chan's formula).  Merging the
+ * accumulators in the same order gives the same result, no matter
+ * which thread filled which accumulator.
+ */
+class dbl_acc
+{
+  std::size_t m_count = 0;
+  double m_min = std::numeric_limits<double>::infinity();
+  double m_max = -std::numeric_limits<double>::infinity();
+  double m_mean = 0;
+  double m_m2 = 0;
+
+public:
+  /// Add a sample.
+  void
+  operator()(double x)
+  {
+    ++m_count;
+    m_min = std::min(m_min, x);
+    m_max = std::max(m_max, x);
+    double delta = x - m_mean;
+    m_mean += delta / m_count;
+    m_m2 += delta * (x - m_mean);
+  }
+
+  /// Merge the samples of the other accumulator into this one.
+  void
+  merge(const dbl_acc &a)
+  {
+    if (!a.m_count)
+      return;
+
+    if (!m_count)
+      {
+        *this = a;
+        return;
+      }
+
+    std::size_t n = m_count + a.m_count;
+    double delta = a.m_mean - m_mean;
+    m_mean += delta * a.m_count / n;
+    m_m2 += a.m_m2 + delta * delta * m_count / n * a.m_count;
+    m_min = std::min(m_min, a.m_min);
+    m_max = std::max(m_max, a.m_max);
+    m_count = n;
+  }
+
+  std::size_t
+  count() const
+  {
+    return m_count;
+  }
+
+  double
+  min() const
+  {
+    return m_min;
+  }
+
+  double
+  max() const
+  {
+    return m_max;
+  }
+
+  double
+  mean() const
+  {
+    return m_mean;
+  }
+
+  /// The population variance, as boost::accumulators reports it.
+  double
+  variance() const
+  {
+    return m_count ? m_m2 / m_count : 0;
+  }
+};
+
+#endif /* DBL_ACC_HPP */
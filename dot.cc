@@ -0,0 +1,123 @@
+#include "dot.hpp"
+
+#include <boost/range.hpp>
+
+#include <cctype>
+
+using namespace std;
+
+/**
+ * True if the text is a valid unquoted DOT identifier, as Boost
+ * checks it: either a letter or an underscore followed by word
+ * characters, or a number with an optional minus sign.
+ */
+static bool
+dot_valid_id(const char *first, const char *last)
+{
+  if (first == last)
+    return false;
+
+  if (isalpha(*first) || *first == '_')
+    {
+      while (++first != last)
+        if (!isalnum(*first) && *first != '_')
+          return false;
+      return true;
+    }
+
+  if (*first == '-')
+    ++first;
+
+  // The number: digits with an optional fraction, or a fraction.
+  bool digits = false;
+  while (first != last && isdigit(*first))
+    {
+      ++first;
+      digits = true;
+    }
+
+  if (first != last && *first == '.')
+    {
+      ++first;
+      while (first != last && isdigit(*first))
+        ++first;
+      return first == last;
+    }
+
+  return digits && first == last;
+}
+
+/**
+ * Write the DOT identifier at first, and quote it if needed.
+ */
+static char *
+dot_id(char *first, const char *id, const char *id_last)
+{
+  if (dot_valid_id(id, id_last))
+    return copy(id, id_last, first);
+
+  // The text we format has no quotes to escape.
+  *first++ = '"';
+  first = copy(id, id_last, first);
+  *first++ = '"';
+
+  return first;
+}
+
+void
+dot_writer::begin(size_t n)
+{
+  m_out.put("graph G {\n");
+
+  for (size_t v = 0; v < n; ++v)
+    {
+      char *p = m_out.reserve(vertex_names::max_size + 2);
+      p = m_names.format(p, v);
+      *p++ = ';';
+      *p++ = '\n';
+      m_out.commit(p);
+    }
+}
+
+void
+dot_writer::edge(size_t u, size_t v, COST w)
+{
+  // The names, the weight with the quotes, and the punctuation.
+  char *p = m_out.reserve(2 * vertex_names::max_size + 64);
+
+  p = m_names.format(p, u);
+  *p++ = '-';
+  *p++ = '-';
+  p = m_names.format(p, v);
+
+  static const char weight[] = "  [weight=";
+  p = copy(weight, weight + sizeof(weight) - 1, p);
+
+  char num[32];
+  p = dot_id(p, num, format_double(num, num + sizeof(num), w));
+
+  *p++ = ']';
+  *p++ = ';';
+  *p++ = '\n';
+  m_out.commit(p);
+}
+
+void
+dot_writer::end()
+{
+  m_out.put("}\n");
+}
+
+void
+write_dot(out_buffer &out, const graph &g, const vertex_names &names)
+{
+  dot_writer dw(out, names);
+
+  dw.begin(num_vertices(g));
+
+  for (edge e: boost::make_iterator_range(edges(g)))
+    dw.edge(source(e, g), target(e, g),
+            boost::get(boost::edge_weight, g, e));
+
+  dw.end();
+}
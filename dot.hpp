@@ -0,0 +1,47 @@
+#ifndef DOT_HPP
+#define DOT_HPP
+
+#include "graph.hpp"
+#include "names.hpp"
+#include "out_buffer.hpp"
+
+#include <cstddef>
+
+/**
+ * The DOT writer.  It writes the graph, vertex by vertex and edge by
+ * edge, in the same text as write_graphviz_dp with the "node_id" and
+ * the "weight" dynamic properties: the names and the weights are
+ * quoted when they are not valid DOT identifiers, and the weights are
+ * formatted like an std::ostream does.
+ */
+class dot_writer
+{
+  out_buffer &m_out;
+  const vertex_names &m_names;
+
+public:
+  dot_writer(out_buffer &out, const vertex_names &names):
+    m_out(out), m_names(names)
+  {
+  }
+
+  /// Write the header and the n vertexes.
+  void
+  begin(std::size_t n);
+
+  /// Write the edge.
+  void
+  edge(std::size_t u, std::size_t v, COST w);
+
+  /// Write the footer.
+  void
+  end();
+};
+
+/**
+ * Write the graph in DOT, in the order of boost::edges().
+ */
+void
+write_dot(out_buffer &out, const graph &g, const vertex_names &names);
+
+#endif /* DOT_HPP */
@@ -0,0 +1,149 @@
+#include "eccentricity.hpp"
+
+#include "sssp.hpp"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+typedef csr_graph::vertex_type vertex_type;
+
+namespace
+{
+  /**
+   * The distances in hops or in length from a source.
+   */
+  class distances
+  {
+    const csr_graph &m_g;
+    bool m_hops;
+    sssp m_sp;
+    std::vector<COST> m_dist;
+    std::vector<vertex_type> m_order;
+
+  public:
+    distances(const csr_graph &g, bool hops):
+      m_g(g), m_hops(hops)
+    {
+    }
+
+    // Find the distances from the source, and return the reached
+    // vertexes in the order of nondecreasing distance.
+    const std::vector<vertex_type> &
+    run(vertex_type src)
+    {
+      if (!m_hops)
+        {
+          m_sp.run(m_g, src);
+          return m_sp.order();
+        }
+
+      // The breadth-first search, with the order as the queue.
+      m_dist.assign(m_g.nr_vertices(), sssp::infinity);
+      m_order.clear();
+
+      m_dist[src] = 0;
+      m_order.push_back(src);
+
+      for (size_t i = 0; i < m_order.size(); ++i)
+        {
+          vertex_type u = m_order[i];
+          for (auto a = m_g.offset(u); a < m_g.offset(u + 1); ++a)
+            {
+              vertex_type v = m_g.targets()[a];
+              if (m_dist[v] == sssp::infinity)
+                {
+                  m_dist[v] = m_dist[u] + 1;
+                  m_order.push_back(v);
+                }
+            }
+        }
+
+      return m_order;
+    }
+
+    COST
+    dist(vertex_type v) const
+    {
+      return m_hops ? m_dist[v] : m_sp.dist(v);
+    }
+  };
+}
+
+eccentricity_result
+eccentricity(const csr_graph &g, bool hops, bool all)
+{
+  vertex_type n = g.nr_vertices();
+
+  eccentricity_result r;
+  r.diameter = 0;
+  r.radius = 0;
+  r.runs = 0;
+
+  if (!n)
+    return r;
+
+  // The bounds of the eccentricities.
+  vector<COST> lower(n, 0);
+  vector<COST> upper(n, sssp::infinity);
+
+  // The bounds of the diameter and the radius.
+  COST dlower = 0;
+  COST rupper = sssp::infinity;
+
+  // The candidates: the nodes still in question.
+  vector<vertex_type> candidates(n);
+  for (vertex_type v = 0; v < n; ++v)
+    candidates[v] = v;
+
+  distances s(g, hops);
+
+  while (!candidates.empty())
+    {
+      // Select the candidate with the largest upper bound, or the
+      // smallest lower bound, and then with the largest degree.
+      bool high = r.runs % 2 == 0;
+      vertex_type v = *min_element(candidates.begin(), candidates.end(),
+                                   [&](vertex_type a, vertex_type b)
+        {
+          if (high ? upper[a] != upper[b] : lower[a] != lower[b])
+            return high ? upper[a] > upper[b] : lower[a] < lower[b];
+          return g.degree(a) > g.degree(b);
+        });
+
+      const vector<vertex_type> &order = s.run(v);
+      ++r.runs;
+
+      // The last vertex reached is the farthest.
+      COST e = s.dist(order.back());
+
+      // Tighten the bounds of the component of the source.
+      for (vertex_type w: order)
+        {
+          COST d = s.dist(w);
+          lower[w] = max(lower[w], max(e - d, d));
+          upper[w] = min(upper[w], e + d);
+          dlower = max(dlower, lower[w]);
+          rupper = min(rupper, upper[w]);
+        }
+
+      // Drop the nodes with their eccentricity known, and those which
+      // can be neither the farthest nor the most central node.
+      auto i = remove_if(candidates.begin(), candidates.end(),
+                         [&](vertex_type w)
+        {
+          return lower[w] >= upper[w] ||
+            (!all && upper[w] <= dlower && lower[w] >= rupper);
+        });
+      candidates.erase(i, candidates.end());
+    }
+
+  r.diameter = dlower;
+  r.radius = rupper;
+
+  if (all)
+    r.ecc = move(lower);
+
+  return r;
+}
@@ -0,0 +1,52 @@
+#ifndef ECCENTRICITY_HPP
+#define ECCENTRICITY_HPP
+
+#include "csr_graph.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * The eccentricities of a graph in hops or in length.  The
+ * eccentricity of a node is its largest distance to a node of its
+ * component.
+ */
+struct eccentricity_result
+{
+  /// The largest eccentricity.
+  COST diameter;
+
+  /// The smallest eccentricity.
+  COST radius;
+
+  /// The eccentricity of every node, or nothing if only the diameter
+  /// and the radius were asked for.
+  std::vector<COST> ecc;
+
+  /// The number of the shortest-path searches run.
+  std::uint32_t runs;
+};
+
+/**
+ * Calculate the exact eccentricities with the bounding algorithm of
+ * Takes and Kosters.  Every node has the lower and the upper bound of
+ * its eccentricity.  The search from node v gives the eccentricity
+ * e(v), and then, by the triangle inequality, the eccentricity of
+ * node w at distance d from v is at least max(e(v) - d, d), and at
+ * most e(v) + d.  The search is run from the nodes whose bounds still
+ * differ, alternately from the one with the largest upper bound and
+ * the one with the smallest lower bound.
+ *
+ * If all is false, only the diameter and the radius are calculated,
+ * and a node is dropped as soon as its bounds show it can be neither
+ * the farthest nor the most central one, which usually leaves a
+ * handful of searches.
+ *
+ * In hops, the distance is the number of links of the path with the
+ * fewest links, found with breadth-first search.  In length, the
+ * distance is the length of the shortest path.
+ */
+eccentricity_result
+eccentricity(const csr_graph &g, bool hops, bool all);
+
+#endif /* ECCENTRICITY_HPP */
@@ -0,0 +1,135 @@
+#ifndef EDGE_PIPE_HPP
+#define EDGE_PIPE_HPP
+
+#include "bounded_queue.hpp"
+#include "graph.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * The pipe of the edges from the generator in one thread to the
+ * writer in another.  The generator uses the pipe as its sink: the
+ * edges are gathered into blocks, and the full blocks are queued.
+ * The other thread drains the pipe into its sink block by block, and
+ * returns the blocks for reuse, so that at most a few blocks exist at
+ * a time.
+ */
+class edge_pipe
+{
+public:
+  struct edge_type
+  {
+    std::uint32_t u;
+    std::uint32_t v;
+    COST w;
+  };
+
+  typedef std::vector<edge_type> block_type;
+
+  /// The exception thrown to the generator when the pipe is cancelled.
+  struct cancelled: std::runtime_error
+  {
+    cancelled():
+      std::runtime_error("edge pipe cancelled")
+    {
+    }
+  };
+
+  explicit edge_pipe(std::size_t blocks = 4,
+                     std::size_t block_size = 1 << 16):
+    m_full(blocks), m_free(blocks), m_block_size(block_size)
+  {
+    for (std::size_t i = 1; i < blocks; ++i)
+      m_free.push(block_type());
+    m_block.reserve(m_block_size);
+  }
+
+  /// -----------------------------------------------------------------
+  /// The generator side.
+  /// -----------------------------------------------------------------
+
+  void
+  begin(std::size_t n)
+  {
+    m_n = n;
+  }
+
+  void
+  edge(std::size_t u, std::size_t v, COST w)
+  {
+    m_block.push_back(edge_type{std::uint32_t(u), std::uint32_t(v), w});
+    if (m_block.size() == m_block_size)
+      send();
+  }
+
+  void
+  end()
+  {
+    // The last block is sent even if empty, so that there is one.
+    if (!m_full.push(std::move(m_block)))
+      throw cancelled();
+    m_full.close();
+  }
+
+  /// -----------------------------------------------------------------
+  /// The writer side.
+  /// -----------------------------------------------------------------
+
+  /**
+   * Pass everything the generator sends to the sink.  If the sink
+   * throws, the pipe is cancelled, and the exception rethrown.
+   */
+  template <typename S>
+  void
+  drain(S &sink)
+  {
+    try
+      {
+        bool first = true;
+        for (block_type b; m_full.pop(b);)
+          {
+            if (first)
+              sink.begin(m_n);
+            first = false;
+            for (const edge_type &e: b)
+              sink.edge(e.u, e.v, e.w);
+            b.clear();
+            m_free.push(std::move(b));
+          }
+        sink.end();
+      }
+    catch (...)
+      {
+        cancel();
+        throw;
+      }
+  }
+
+  /// Make the generator stop with the cancelled exception.
+  void
+  cancel()
+  {
+    m_full.close();
+    m_free.close();
+  }
+
+private:
+  void
+  send()
+  {
+    if (!m_full.push(std::move(m_block)) || !m_free.pop(m_block))
+      throw cancelled();
+    m_block.reserve(m_block_size);
+  }
+
+  bounded_queue<block_type> m_full;
+  bounded_queue<block_type> m_free;
+  std::size_t m_block_size;
+  block_type m_block;
+  std::size_t m_n = 0;
+};
+
+#endif /* EDGE_PIPE_HPP */
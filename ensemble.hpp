@@ -0,0 +1,31 @@
+#ifndef ENSEMBLE_HPP
+#define ENSEMBLE_HPP
+
+#include "parallel.hpp"
+
+#include <vector>
+
+/**
+ * Run the replicas of an ensemble on a pool of threads, and return
+ * the merged result.  The replica function f(i) returns the result of
+ * replica i, which has to provide the merge(const R &) function.  The
+ * results are merged in the order of the replicas, so the merged
+ * result is the same for any number of threads.
+ */
+template <typename R, typename F>
+R
+run_ensemble(int replicas, unsigned threads, F f)
+{
+  std::vector<R> results(replicas);
+
+  parallel_for(replicas, threads, [&](std::size_t i, unsigned)
+               {results[i] = f(i);});
+
+  R result;
+  for (const R &r: results)
+    result.merge(r);
+
+  return result;
+}
+
+#endif /* ENSEMBLE_HPP */
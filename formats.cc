@@ -0,0 +1,152 @@
+#include "formats.hpp"
+
+#include <boost/range.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+void
+edges_writer::edge(size_t u, size_t v, COST w)
+{
+  char *p = m_out.reserve(2 * vertex_names::max_size + 32);
+
+  p = m_names.format(p, u);
+  *p++ = ' ';
+  p = m_names.format(p, v);
+  *p++ = ' ';
+  p = format_exact(p, p + 30, w);
+  *p++ = '\n';
+  m_out.commit(p);
+}
+
+void
+graphml_writer::begin(size_t n, const location *locations)
+{
+  m_out.put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+            "  <key id=\"weight\" for=\"edge\" attr.name=\"weight\" "
+            "attr.type=\"double\"/>\n");
+  if (locations)
+    m_out.put("  <key id=\"x\" for=\"node\" attr.name=\"x\" "
+              "attr.type=\"double\"/>\n"
+              "  <key id=\"y\" for=\"node\" attr.name=\"y\" "
+              "attr.type=\"double\"/>\n");
+  m_out.put("  <graph id=\"G\" edgedefault=\"undirected\">\n");
+
+  for (size_t v = 0; v < n; ++v)
+    {
+      char *p = m_out.reserve(vertex_names::max_size + 128);
+
+      static const char node[] = "    <node id=\"";
+      p = copy(node, node + sizeof(node) - 1, p);
+      p = m_names.format(p, v);
+
+      if (locations)
+        {
+          static const char x[] = "\"><data key=\"x\">";
+          static const char y[] = "</data><data key=\"y\">";
+          static const char close[] = "</data></node>\n";
+          p = copy(x, x + sizeof(x) - 1, p);
+          p = format_exact(p, p + 30, locations[v].x);
+          p = copy(y, y + sizeof(y) - 1, p);
+          p = format_exact(p, p + 30, locations[v].y);
+          p = copy(close, close + sizeof(close) - 1, p);
+        }
+      else
+        {
+          static const char close[] = "\"/>\n";
+          p = copy(close, close + sizeof(close) - 1, p);
+        }
+
+      m_out.commit(p);
+    }
+}
+
+void
+graphml_writer::edge(size_t u, size_t v, COST w)
+{
+  char *p = m_out.reserve(2 * vertex_names::max_size + 128);
+
+  static const char source[] = "    <edge source=\"";
+  static const char target[] = "\" target=\"";
+  static const char data[] = "\"><data key=\"weight\">";
+  static const char close[] = "</data></edge>\n";
+
+  p = copy(source, source + sizeof(source) - 1, p);
+  p = m_names.format(p, u);
+  p = copy(target, target + sizeof(target) - 1, p);
+  p = m_names.format(p, v);
+  p = copy(data, data + sizeof(data) - 1, p);
+  p = format_exact(p, p + 30, w);
+  p = copy(close, close + sizeof(close) - 1, p);
+  m_out.commit(p);
+}
+
+void
+graphml_writer::end()
+{
+  m_out.put("  </graph>\n</graphml>\n");
+}
+
+void
+write_edges(out_buffer &out, const graph &g, const vertex_names &names)
+{
+  edges_writer ew(out, names);
+
+  ew.begin(num_vertices(g));
+
+  for (edge e: boost::make_iterator_range(edges(g)))
+    ew.edge(source(e, g), target(e, g),
+            boost::get(boost::edge_weight, g, e));
+
+  ew.end();
+}
+
+void
+write_graphml(out_buffer &out, const graph &g, const vertex_names &names)
+{
+  graphml_writer gw(out, names);
+
+  vector<location> locations;
+  if (g[boost::graph_bundle].located)
+    for (vertex v: boost::make_iterator_range(vertices(g)))
+      locations.push_back(g[v]);
+
+  gw.begin(num_vertices(g), locations.empty() ? nullptr : locations.data());
+
+  for (edge e: boost::make_iterator_range(edges(g)))
+    gw.edge(source(e, g), target(e, g),
+            boost::get(boost::edge_weight, g, e));
+
+  gw.end();
+}
+
+void
+write_metis(out_buffer &out, const csr_graph &g)
+{
+  out.put_int(g.nr_vertices());
+  out.put(' ');
+  out.put_int(g.nr_edges());
+  // The format code 1: the edges have weights.
+  out.put(" 1\n");
+
+  const auto *targets = g.targets();
+  const auto *weights = g.weights();
+
+  for (csr_graph::vertex_type v = 0; v < g.nr_vertices(); ++v)
+    {
+      for (auto i = g.offset(v); i < g.offset(v + 1); ++i)
+        {
+          char *p = out.reserve(64);
+          if (i != g.offset(v))
+            *p++ = ' ';
+          p = to_chars(p, p + 16, targets[i] + 1).ptr;
+          *p++ = ' ';
+          p = format_exact(p, p + 30, weights[i]);
+          out.commit(p);
+        }
+      out.put('\n');
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef FORMATS_HPP
+#define FORMATS_HPP
+
+#include "csr_graph.hpp"
+#include "graph.hpp"
+#include "names.hpp"
+#include "out_buffer.hpp"
+
+#include <cstddef>
+
+/**
+ * The edge list writer: an edge per line, with the names of the two
+ * vertexes and the weight separated with spaces, as read_graph reads
+ * it.  There is no header, so an isolated vertex is not written.
+ */
+class edges_writer
+{
+  out_buffer &m_out;
+  const vertex_names &m_names;
+
+public:
+  edges_writer(out_buffer &out, const vertex_names &names):
+    m_out(out), m_names(names)
+  {
+  }
+
+  void
+  begin(std::size_t)
+  {
+  }
+
+  void
+  edge(std::size_t u, std::size_t v, COST w);
+
+  void
+  end()
+  {
+  }
+};
+
+/**
+ * The GraphML writer.  The vertexes are written with their locations,
+ * if given, and the edges with their weights.
+ */
+class graphml_writer
+{
+  out_buffer &m_out;
+  const vertex_names &m_names;
+
+public:
+  graphml_writer(out_buffer &out, const vertex_names &names):
+    m_out(out), m_names(names)
+  {
+  }
+
+  /// Write the header and the n vertexes, with the locations if given.
+  void
+  begin(std::size_t n, const location *locations = nullptr);
+
+  void
+  edge(std::size_t u, std::size_t v, COST w);
+
+  void
+  end();
+};
+
+/**
+ * Write the graph as an edge list, in the order of boost::edges().
+ */
+void
+write_edges(out_buffer &out, const graph &g, const vertex_names &names);
+
+/**
+ * Write the graph in GraphML, in the order of boost::edges().
+ */
+void
+write_graphml(out_buffer &out, const graph &g, const vertex_names &names);
+
+/**
+ * Write the graph in the METIS format with the edge weights: the
+ * header with the numbers of vertexes and edges, and a line per
+ * vertex with its neighbors, numbered from 1, and the weights.
+ * METIS takes integer weights only, and the generated weights are.
+ */
+void
+write_metis(out_buffer &out, const csr_graph &g);
+
+#endif /* FORMATS_HPP */
@@ -4,18 +4,17 @@
 #include "teventqueue.hpp"
 #include "utils.hpp"
 
-#include <stdlib.h>     /* srand, rand */
-#include <time.h>   
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
 using namespace std;
 
 graph
-generate_gabriel_graph(const cli_args &args)
+generate_gabriel_graph(const cli_args &args, const philox &eng,
+                       union_find &uf)
 {
   assert(args.nr_nodes >= 2);
-  srand (args.seed);
   // Create a graph with the following number of nodes.
   graph g = graph(args.nr_nodes);
 
@@ -30,7 +29,7 @@ generate_gabriel_graph(const cli_args &args)
   unsigned skm = number * 10000;
   unsigned int w = std::sqrt(skm);
   unsigned int h = std::sqrt(skm);
-  list<TNode *> P = generate_Nodes(w, h, number);
+  list<TNode *> P = generate_Nodes(w, h, number, eng);
   
   list<TTriangle *> triangles;
   delaunayTriangulation(triangles, P);
@@ -40,24 +39,38 @@ generate_gabriel_graph(const cli_args &args)
   unsigned int edges = edgeNumber(P);
   
   map<TNode*, vertex> mapNV;
+  uf.reset(args.nr_nodes);
   
   std::set<vertex>::iterator itV = lonely.begin();
   for (list<TNode *>::iterator it = P.begin(); it != P.end(); ++it, ++itV)
-    mapNV[*it] = *itV;
+    {
+      mapNV[*it] = *itV;
+      g[*itV].x = (*it)->getPoint().getX();
+      g[*itV].y = (*it)->getPoint().getY();
+    }
+  g[boost::graph_bundle].located = true;
   
   for (list<TNode *>::iterator it = P.begin(); it != P.end(); ++it, ++itV)
   {
       vertex src = mapNV[*it];
       set<TNode*> myEdges = (*it)->getEdges();
-      
-      for (set<TNode*>::iterator itE = myEdges.begin(); itE != myEdges.end(); ++itE)
+
+      // Add the edges in the order of the vertexes, and not of the
+      // node addresses, which differ from run to run.
+      vector<pair<vertex, TNode *>> dsts;
+      for (TNode *n: myEdges)
+        dsts.push_back(make_pair(mapNV[n], n));
+      sort(dsts.begin(), dsts.end());
+
+      for (auto itE = dsts.begin(); itE != dsts.end(); ++itE)
       {
-         vertex dst = mapNV[*itE];      
-         (*itE)->removeEdge(*it);
+         vertex dst = itE->first;
+         itE->second->removeEdge(*it);
          edge e;
          bool status;
          tie(e, status) = add_edge(src, dst, g);
-         int dist = (int) (sqrt(dist2((*it)->getPoint(), (*itE)->getPoint())) + 0.5);
+         uf.unite(src, dst);
+         int dist = (int) (sqrt(dist2((*it)->getPoint(), itE->second->getPoint())) + 0.5);
          wm[e] = dist;
          assert(status);    
       }
@@ -3,18 +3,23 @@
 
 #include "graph.hpp"
 #include "cli_args.hpp"
+#include "philox.hpp"
+#include "union_find.hpp"
 
 using namespace std;
 
 /**
  * Generate the Gabriel graph.  The graph has one connected component.
  * We don't allow for loop edges (i.e. that start and end at the same
- * node), and we don't allow for parallel edges.
+ * node), and we don't allow for parallel edges.  The node locations
+ * are drawn from the streams of the engine.  The union-find tracks
+ * the components as the edges are added.
  *
  * @return the graph
  */
 
 graph
-generate_gabriel_graph(const cli_args &args);
+generate_gabriel_graph(const cli_args &args, const philox &eng,
+                       union_find &uf);
 
 #endif /* GABRIEL_HPP */
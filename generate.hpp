@@ -1,15 +1,28 @@
 #ifndef GENERATE_HPP
 #define GENERATE_HPP
 
+#include "augment.hpp"
 #include "cli_args.hpp"
 #include "gabriel.hpp"
 #include "graph.hpp"
+#include "philox.hpp"
 #include "random.hpp"
+#include "union_find.hpp"
 #include "utils.hpp"
 
-template<typename T>
-graph
-generate_graph(const cli_args &args, T &eng)
+/**
+ * Generate the graph with the given counter-based engine.  The
+ * generators draw from the streams of the engine only, so the graph
+ * depends on the key of the engine (the seed and the replica number)
+ * and nothing else.  The generators maintain the union-find of the
+ * vertexes as they add the edges, so that the connectivity of the
+ * graph is known at no extra cost: it is connected if uf.count() is 1.
+ *
+ * The graph is then augmented to the requested connectivity, and the
+ * number of the edges added is recorded in the graph properties.
+ */
+inline graph
+generate_graph(const cli_args &args, const philox &eng, union_find &uf)
 {
   graph g;
 
@@ -17,19 +30,19 @@ generate_graph(const cli_args &args, T &eng)
   switch (nt)
     {
     case nt_t::random_network:
-      g = generate_random_graph(args, eng);
+      g = generate_random_graph(args, eng, uf);
       break;
       
     case nt_t::gabriel_network:
-      g = generate_gabriel_graph(args);
+      g = generate_gabriel_graph(args, eng, uf);
       break;
 
     default:
       abort();
     }
-  
-  // Name the vertexes.
-  name_vertices(g);
+
+  g[boost::graph_bundle].added =
+    augment(g, survivable_interpret(args.survivable), eng);
 
   return g;
 }
@@ -14,14 +14,34 @@
 // The type of cost of reaching a vertex.
 typedef double COST;
 
+// The location of a vertex in the plane.
+struct location
+{
+  double x = 0;
+  double y = 0;
+};
+
+// The properties of the whole graph.
+struct graph_info
+{
+  // True if the vertexes have locations.
+  bool located = false;
+
+  // The number of the edges added to make the graph survivable.
+  int added = 0;
+};
+
 /**
  * The type of the graph we use.  The edge_ssc_t property describes
- * the slices available, i.e. not already taken.
+ * the slices available, i.e. not already taken.  The vertexes have
+ * no names stored: the writers format them with vertex_names.  The
+ * generators of geometric graphs set the vertex locations.
  */
 typedef
 boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS,
-		      boost::property<boost::vertex_name_t, std::string>,
-                      boost::property<boost::edge_weight_t, COST> >
+		      location,
+                      boost::property<boost::edge_weight_t, COST>,
+                      graph_info>
 graph;
 
 typedef graph::edge_descriptor edge;
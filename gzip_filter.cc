@@ -0,0 +1,66 @@
+#include "gzip_filter.hpp"
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+// The size of the piece of the next buffer we deflate into.
+static const size_t chunk = 1 << 16;
+
+gzip_filter::gzip_filter(out_buffer &next, int level):
+  m_next(next), m_zs()
+{
+  // The window bits of 15, plus 16 for the gzip header and trailer.
+  if (deflateInit2(&m_zs, level, Z_DEFLATED, 15 + 16, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK)
+    throw runtime_error("deflateInit2 failed");
+}
+
+gzip_filter::~gzip_filter()
+{
+  deflateEnd(&m_zs);
+}
+
+void
+gzip_filter::write(const char *p, size_t n)
+{
+  // The input size of zlib is an unsigned int.
+  while (n)
+    {
+      uInt size = n < chunk ? n : chunk;
+      m_zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(p));
+      m_zs.avail_in = size;
+      deflate(Z_NO_FLUSH);
+      p += size;
+      n -= size;
+    }
+}
+
+void
+gzip_filter::finish()
+{
+  m_zs.next_in = nullptr;
+  m_zs.avail_in = 0;
+  deflate(Z_FINISH);
+}
+
+void
+gzip_filter::deflate(int flush)
+{
+  int ret;
+
+  do
+    {
+      char *out = m_next.reserve(chunk);
+      m_zs.next_out = reinterpret_cast<Bytef *>(out);
+      m_zs.avail_out = chunk;
+
+      ret = ::deflate(&m_zs, flush);
+      if (ret == Z_STREAM_ERROR)
+        throw runtime_error("deflate failed");
+
+      m_next.commit(out + chunk - m_zs.avail_out);
+    }
+  while (m_zs.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+}
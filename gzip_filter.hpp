@@ -0,0 +1,45 @@
+#ifndef GZIP_FILTER_HPP
+#define GZIP_FILTER_HPP
+
+#include "out_buffer.hpp"
+
+#include <cstddef>
+
+#include <zlib.h>
+
+/**
+ * The gzip compression of the text on its way to the next buffer: an
+ * out_buffer made with this filter formats the text, and the filter
+ * deflates it straight into the next buffer, a piece at a time, so
+ * that the uncompressed text is never held in whole.
+ *
+ * The stream has to be finished with finish() once the text is
+ * flushed.  Throws std::runtime_error on a zlib error.
+ */
+class gzip_filter: public out_filter
+{
+public:
+  /// Compress with the zlib level, from 1 (fastest) to 9 (best).
+  explicit gzip_filter(out_buffer &next, int level = Z_DEFAULT_COMPRESSION);
+
+  ~gzip_filter();
+
+  gzip_filter(const gzip_filter &) = delete;
+  gzip_filter &operator=(const gzip_filter &) = delete;
+
+  void
+  write(const char *p, std::size_t n) override;
+
+  /// Write the end of the gzip stream.
+  void
+  finish();
+
+private:
+  void
+  deflate(int flush);
+
+  out_buffer &m_next;
+  z_stream m_zs;
+};
+
+#endif /* GZIP_FILTER_HPP */
@@ -0,0 +1,122 @@
+#ifndef HISTOGRAM_ACC_HPP
+#define HISTOGRAM_ACC_HPP
+
+#include "dbl_acc.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * The histogram of the non-negative integer samples, like the degrees
+ * or the hops, with the buckets of a fixed width: bucket i counts the
+ * samples from i * width to (i + 1) * width - 1.  The buckets are
+ * added as the samples need them.  The count, the min, the max, the
+ * mean and the variance are kept by dbl_acc, and with the width of 1
+ * the quantiles are exact.  Two histograms of the same width are
+ * merged by adding their buckets, which gives the same result in any
+ * order.
+ */
+class histogram_acc
+{
+  std::uint64_t m_width;
+  dbl_acc m_moments;
+  std::vector<std::uint64_t> m_buckets;
+
+public:
+  explicit histogram_acc(std::uint64_t width = 1):
+    m_width(width)
+  {
+    assert(width > 0);
+  }
+
+  /// Add a sample.
+  void
+  operator()(std::uint64_t x)
+  {
+    m_moments(x);
+
+    std::size_t i = x / m_width;
+    if (m_buckets.size() <= i)
+      m_buckets.resize(i + 1, 0);
+    ++m_buckets[i];
+  }
+
+  /// Merge the samples of the other histogram into this one.
+  void
+  merge(const histogram_acc &a)
+  {
+    assert(m_width == a.m_width);
+    m_moments.merge(a.m_moments);
+
+    if (m_buckets.size() < a.m_buckets.size())
+      m_buckets.resize(a.m_buckets.size(), 0);
+    for (std::size_t i = 0; i < a.m_buckets.size(); ++i)
+      m_buckets[i] += a.m_buckets[i];
+  }
+
+  /// The start of the bucket with the sample of rank ceil(q * count),
+  /// from 1, or NaN if there are no samples.
+  double
+  quantile(double q) const
+  {
+    if (!count())
+      return std::numeric_limits<double>::quiet_NaN();
+
+    double rank = std::max(1.0, std::ceil(q * count()));
+    std::uint64_t seen = 0;
+    std::size_t i = 0;
+    while ((seen += m_buckets[i]) < rank)
+      ++i;
+
+    return i * m_width;
+  }
+
+  std::uint64_t
+  width() const
+  {
+    return m_width;
+  }
+
+  const std::vector<std::uint64_t> &
+  buckets() const
+  {
+    return m_buckets;
+  }
+
+  std::size_t
+  count() const
+  {
+    return m_moments.count();
+  }
+
+  double
+  min() const
+  {
+    return m_moments.min();
+  }
+
+  double
+  max() const
+  {
+    return m_moments.max();
+  }
+
+  double
+  mean() const
+  {
+    return m_moments.mean();
+  }
+
+  double
+  variance() const
+  {
+    return m_moments.variance();
+  }
+};
+
+#endif /* HISTOGRAM_ACC_HPP */
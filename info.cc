@@ -1,28 +1,38 @@
+#include "betweenness.hpp"
+#include "csr_graph.hpp"
+#include "cuts.hpp"
+#include "eccentricity.hpp"
+#include "ensemble.hpp"
 #include "generate.hpp"
 #include "graph.hpp"
 #include "cli_args.hpp"
+#include "order.hpp"
+#include "out_buffer.hpp"
+#include "percolation.hpp"
+#include "print_stats.hpp"
+#include "query.hpp"
+#include "read_graph.hpp"
+#include "spectral.hpp"
+#include "triangles.hpp"
 #include "utils.hpp"
 
-#include <boost/random.hpp>
-
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
 
+#include <unistd.h>
+
 using namespace std;
 
-template<typename T>
-void
-print_stats(const string &s, const T &t)
-{
-  cout << s << ": "
-       << "min = " << ba::min(t) << ", "
-       << "mean = " << ba::mean(t) << ", "
-       << "max = " << ba::max(t) << ", "
-       << "variance = " << ba::variance(t) << endl;
-}
-
-void
-net_stats(const cli_args &args_orig)
+/**
+ * The statistics of the networks.  An object holds the statistics of
+ * a single replica, or the merged statistics of a number of replicas.
+ */
+struct net_acc
 {
   // Number of nodes.
   dbl_acc nns;
@@ -31,62 +41,683 @@ net_stats(const cli_args &args_orig)
   dbl_acc nls;
 
   // Link lengths.
-  dbl_acc lls;
+  quantile_acc lls;
 
   // Node degrees.
-  dbl_acc nds;
+  histogram_acc nds;
 
   // Shortest path number of hops.
-  dbl_acc sphs;
+  histogram_acc sphs;
 
   // Shortest path lengths.
-  dbl_acc spls;
-  
-  for (int i = 0; i < 100; ++i)
+  quantile_acc spls;
+
+  // The number of node pairs without a path.
+  std::uint64_t unreachable = 0;
+
+  void
+  merge(const net_acc &a)
+  {
+    unreachable += a.unreachable;
+    nns.merge(a.nns);
+    nls.merge(a.nls);
+    lls.merge(a.lls);
+    nds.merge(a.nds);
+    sphs.merge(a.sphs);
+    spls.merge(a.spls);
+  }
+};
+
+// Analyse the graph.
+net_acc
+graph_stats(const csr_graph &g)
+{
+  net_acc a;
+
+  // Record the number of nodes and links.
+  a.nns(g.nr_vertices());
+  a.nls(g.nr_edges());
+
+  // Calculate the mean value of the edge lengths.  Every edge is
+  // stored as two arcs, and we take the one to the larger vertex.
+  for (csr_graph::vertex_type v = 0; v < g.nr_vertices(); ++v)
+    for (auto i = g.offset(v); i < g.offset(v + 1); ++i)
+      if (g.targets()[i] > v)
+        a.lls(g.weights()[i]);
+
+  // Calculate the mean value of the node degree.
+  for (csr_graph::vertex_type v = 0; v < g.nr_vertices(); ++v)
+    a.nds(g.degree(v));
+
+  // Calculate the shortest path statistics.
+  a.unreachable = calc_sp_stats(g, a.sphs, a.spls);
+
+  return a;
+}
+
+// Generate the graph of the replica with the random number generator.
+csr_graph
+replica_graph(const cli_args &args, order_t order, const philox &rng)
+{
+  // Generate the graph, and finalize it into the CSR graph with the
+  // vertexes in the requested order.
+  union_find uf;
+  graph gg = generate_graph(args, rng, uf);
+  assert(uf.count() == 1);
+
+  return reorder(make_csr(gg), order);
+}
+
+// Read the given input graph.
+csr_graph
+input_graph(const cli_args &args, order_t order, int input)
+{
+  // The threads parse the file if there is only one file.
+  unsigned threads = args.inputs.size() == 1 ? args.threads : 1;
+
+  return reorder(read_graph(args.inputs[input], threads), order);
+}
+
+typedef chrono::steady_clock timer;
+
+// The seconds elapsed since the time point.
+double
+elapsed(timer::time_point start)
+{
+  return chrono::duration<double>(timer::now() - start).count();
+}
+
+// The mutex of the replica records.
+mutex replica_mutex;
+
+/**
+ * Print the record of replica i, if requested, with the times in
+ * seconds of its generation (or reading) and of its analysis, and
+ * with its statistics printed by print(p, r).  The records are
+ * printed as the replicas finish, so they come in the order of
+ * finishing, and they are flushed for the long runs to be watched.
+ */
+template <typename R, typename P>
+void
+print_replica(const cli_args &args, int i, double generation,
+              double analysis, const R &r, P print)
+{
+  if (!args.per_replica)
+    return;
+
+  lock_guard<mutex> lock(replica_mutex);
+  stats_printer p(cout, stats_format_interpret(args.stats_format));
+  p.begin();
+  p.start("Replica");
+  p.value("index", i);
+  p.value("generation [s]", generation);
+  p.value("analysis [s]", analysis);
+  p.finish();
+  print(p, r);
+  p.end();
+  cout.flush();
+}
+
+/**
+ * Print the record of the ensemble, with its statistics printed by
+ * print(p, a).  If the records of the replicas were printed, the
+ * record starts with the number of the replicas, so that it can be
+ * told from them.
+ */
+template <typename R, typename P>
+void
+print_ensemble(const cli_args &args, const R &a, P print)
+{
+  stats_printer p(cout, stats_format_interpret(args.stats_format));
+  p.begin();
+  if (args.per_replica)
     {
-      cli_args args = args_orig;
-      
-      args.seed += i;
-      
-      // Random number generator.
-      boost::mt19937 rng(args.seed);
-
-      // Generate the graph.
-      graph g = generate_graph(args, rng);
-
-      assert(is_connected(g));
-
-      // Record the number of nodes and links.
-      nns(num_vertices(g));
-      nls(num_edges(g));
-      
-      // Calculate the mean value of the edge lengths.
-      auto es = boost::edges(g);
-      for (auto ei = es.first; ei != es.second; ++ei)
-        lls(boost::get(boost::edge_weight, g, *ei));
-
-      // Calculate the mean value of the node degree.
-      auto ns = boost::vertices(g);
-      for (auto ni = ns.first; ni != ns.second; ++ni)
-        nds(boost::out_degree(*ni, g));
-
-      // Calculate the shortest path statistics.
-      calc_sp_stats(g, sphs, spls);
+      p.start("Ensemble");
+      p.value("replicas", args.inputs.empty() ? args.replicas :
+              args.inputs.size());
+      p.finish();
     }
+  print(p, a);
+  p.end();
+}
+
+/**
+ * Run the analysis on the generated replicas, or on the input graphs,
+ * and merge the results.  The analysis f(g, rng) of graph g gets the
+ * random number generator of the replica, or of the input.  The
+ * results of the replicas are printed with print(p, r) if requested.
+ */
+template <typename R, typename F, typename P>
+R
+run_analysis(const cli_args &args, F f, P print)
+{
+  order_t order = order_interpret(args.order);
+  bool generated = args.inputs.empty();
+
+  return run_ensemble<R>(generated ? args.replicas : args.inputs.size(),
+                         args.threads, [&](int i)
+    {
+      // The random number generator of the replica.
+      philox rng(args.seed, i);
+
+      auto start = timer::now();
+      csr_graph g = generated ? replica_graph(args, order, rng) :
+        input_graph(args, order, i);
+      double generation = elapsed(start);
+
+      start = timer::now();
+      R r = f(g, rng);
+      print_replica(args, i, generation, elapsed(start), r, print);
+
+      return r;
+    });
+}
+
+void
+net_stats(const cli_args &args)
+{
+  auto print = [](stats_printer &p, const net_acc &a)
+    {
+      print_stats(p, "Number of nodes", a.nns);
+      print_stats(p, "Number of links", a.nls);
+      print_stats(p, "Link length", a.lls);
+      print_stats(p, "Node degree", a.nds);
+      print_stats(p, "Shortest path hops", a.sphs);
+      print_stats(p, "Shortest path length", a.spls);
+    };
+
+  net_acc a = run_analysis<net_acc>(args, [](const csr_graph &g,
+                                             const philox &)
+                                    {return graph_stats(g);}, print);
+
+  if (a.unreachable)
+    cerr << "Warning: " << a.unreachable
+         << " node pairs without a path were skipped." << endl;
+
+  print_ensemble(args, a, print);
+}
+
+/**
+ * The percolation curves of the networks, for a replica, or merged
+ * for a number of replicas.
+ */
+struct percolation_acc
+{
+  // The size of the largest component at the points of the curve.
+  std::vector<dbl_acc> giant;
+
+  // The robustness.
+  dbl_acc robustness;
+
+  void
+  merge(const percolation_acc &a)
+  {
+    giant.resize(a.giant.size());
+    for (size_t k = 0; k < a.giant.size(); ++k)
+      giant[k].merge(a.giant[k]);
+    robustness.merge(a.robustness);
+  }
+};
+
+void
+percolation_stats(const cli_args &args)
+{
+  attack_t attack = attack_interpret(args.attack);
+
+  auto print = [&](stats_printer &p, const percolation_acc &a)
+    {
+      for (int k = 0; k <= args.points; ++k)
+        {
+          ostringstream os;
+          os << "Largest component, " << double(k) / args.points
+             << " removed";
+          print_stats(p, os.str(), a.giant[k]);
+        }
+
+      print_stats(p, "Robustness", a.robustness);
+    };
+
+  percolation_acc a = run_analysis<percolation_acc>
+    (args, [&](const csr_graph &g, const philox &rng)
+     {
+       percolation_result r = percolation(g, attack, args.points, rng);
 
-  print_stats("Number of nodes", nns);
-  print_stats("Number of links", nls);
-  print_stats("Link length", lls);
-  print_stats("Node degree", nds);
-  print_stats("Shortest path hops", sphs);
-  print_stats("Shortest path length", spls);
+       percolation_acc a;
+       a.giant.resize(r.giant.size());
+       for (size_t k = 0; k < r.giant.size(); ++k)
+         a.giant[k](r.giant[k]);
+       a.robustness(r.robustness);
+       return a;
+     }, print);
+
+  print_ensemble(args, a, print);
+}
+
+/**
+ * The loads of the networks, for a replica, or merged for a number of
+ * replicas.
+ */
+struct load_acc
+{
+  // The node betweenness.
+  quantile_acc node;
+
+  // The link load.
+  quantile_acc link;
+
+  void
+  merge(const load_acc &a)
+  {
+    node.merge(a.node);
+    link.merge(a.link);
+  }
+};
+
+void
+betweenness_stats(const cli_args &args)
+{
+  // The threads go to the sources if there is only one graph.
+  int graphs = args.inputs.empty() ? args.replicas : args.inputs.size();
+  unsigned threads = graphs == 1 ? args.threads : 1;
+
+  auto print = [](stats_printer &p, const load_acc &a)
+    {
+      print_stats(p, "Node betweenness", a.node);
+      print_stats(p, "Link load", a.link);
+    };
+
+  load_acc a = run_analysis<load_acc>
+    (args, [&](const csr_graph &g, const philox &rng)
+     {
+       betweenness_result r = betweenness(g, threads, args.samples, rng);
+
+       load_acc a;
+       for (double x: r.node)
+         a.node(x);
+       for (double x: r.link)
+         a.link(x);
+       return a;
+     }, print);
+
+  print_ensemble(args, a, print);
+}
+
+/**
+ * The eccentricities of the networks, for a replica, or merged for a
+ * number of replicas.
+ */
+struct eccentricity_acc
+{
+  // The diameter, the radius, the eccentricities, and the number of
+  // the searches, in hops and in length.
+  dbl_acc diameter[2];
+  dbl_acc radius[2];
+  quantile_acc ecc[2];
+  dbl_acc runs[2];
+
+  void
+  merge(const eccentricity_acc &a)
+  {
+    for (int k = 0; k < 2; ++k)
+      {
+        diameter[k].merge(a.diameter[k]);
+        radius[k].merge(a.radius[k]);
+        ecc[k].merge(a.ecc[k]);
+        runs[k].merge(a.runs[k]);
+      }
+  }
+};
+
+void
+eccentricity_stats(const cli_args &args, bool all)
+{
+  auto print = [&](stats_printer &p, const eccentricity_acc &a)
+    {
+      const char *metric[] = {"hops", "length"};
+      for (int k = 0; k < 2; ++k)
+        {
+          print_stats(p, string("Diameter ") + metric[k], a.diameter[k]);
+          print_stats(p, string("Radius ") + metric[k], a.radius[k]);
+          if (all)
+            print_stats(p, string("Eccentricity ") + metric[k],
+                        a.ecc[k]);
+          print_stats(p, string("Searches ") + metric[k], a.runs[k]);
+        }
+    };
+
+  eccentricity_acc a = run_analysis<eccentricity_acc>
+    (args, [&](const csr_graph &g, const philox &)
+     {
+       eccentricity_acc a;
+       for (int k = 0; k < 2; ++k)
+         {
+           eccentricity_result r = eccentricity(g, k == 0, all);
+           a.diameter[k](r.diameter);
+           a.radius[k](r.radius);
+           for (COST e: r.ecc)
+             a.ecc[k](e);
+           a.runs[k](r.runs);
+         }
+       return a;
+     }, print);
+
+  print_ensemble(args, a, print);
+}
+
+/**
+ * The triangles of the networks, for a replica, or merged for a
+ * number of replicas.
+ */
+struct clustering_acc
+{
+  // The number of triangles.
+  dbl_acc triangles;
+
+  // The global clustering coefficient.
+  dbl_acc global;
+
+  // The local clustering coefficients of the nodes.
+  dbl_acc local;
+
+  void
+  merge(const clustering_acc &a)
+  {
+    triangles.merge(a.triangles);
+    global.merge(a.global);
+    local.merge(a.local);
+  }
+};
+
+void
+clustering_stats(const cli_args &args)
+{
+  // The threads go to the nodes if there is only one graph.
+  int graphs = args.inputs.empty() ? args.replicas : args.inputs.size();
+  unsigned threads = graphs == 1 ? args.threads : 1;
+
+  auto print = [](stats_printer &p, const clustering_acc &a)
+    {
+      print_stats(p, "Triangles", a.triangles);
+      print_stats(p, "Global clustering", a.global);
+      print_stats(p, "Local clustering", a.local);
+    };
+
+  clustering_acc a = run_analysis<clustering_acc>
+    (args, [&](const csr_graph &g, const philox &)
+     {
+       triangle_result r = triangles(g, threads);
+
+       clustering_acc a;
+       a.triangles(r.triangles);
+       a.global(r.global());
+       for (csr_graph::vertex_type v = 0; v < g.nr_vertices(); ++v)
+         a.local(r.local(v, g.degree(v)));
+       return a;
+     }, print);
+
+  print_ensemble(args, a, print);
+}
+
+/**
+ * The eigenvalues of the networks, for a replica, or merged for a
+ * number of replicas.
+ */
+struct spectrum_acc
+{
+  // The algebraic connectivity.
+  dbl_acc connectivity;
+
+  // The spectral radius.
+  dbl_acc radius;
+
+  // The numbers of the Lanczos iterations of the two solves.
+  dbl_acc connectivity_iterations, radius_iterations;
+
+  // The number of the eigenvalues that did not converge.
+  int unconverged = 0;
+
+  void
+  merge(const spectrum_acc &a)
+  {
+    connectivity.merge(a.connectivity);
+    radius.merge(a.radius);
+    connectivity_iterations.merge(a.connectivity_iterations);
+    radius_iterations.merge(a.radius_iterations);
+    unconverged += a.unconverged;
+  }
+};
+
+void
+spectrum_stats(const cli_args &args)
+{
+  // The threads go to the products if there is only one graph.
+  int graphs = args.inputs.empty() ? args.replicas : args.inputs.size();
+  unsigned threads = graphs == 1 ? args.threads : 1;
+
+  auto print = [](stats_printer &p, const spectrum_acc &a)
+    {
+      print_stats(p, "Algebraic connectivity", a.connectivity);
+      print_stats(p, "Spectral radius", a.radius);
+      print_stats(p, "Lanczos iterations, connectivity",
+                  a.connectivity_iterations);
+      print_stats(p, "Lanczos iterations, radius", a.radius_iterations);
+    };
+
+  spectrum_acc a = run_analysis<spectrum_acc>
+    (args, [&](const csr_graph &g, const philox &rng)
+     {
+       eigen_result c = algebraic_connectivity(g, threads, rng);
+       eigen_result r = spectral_radius(g, threads, rng);
+
+       spectrum_acc a;
+       a.connectivity(c.value);
+       a.radius(r.value);
+       a.connectivity_iterations(c.iterations);
+       a.radius_iterations(r.iterations);
+       a.unconverged = !c.converged + !r.converged;
+       return a;
+     }, print);
+
+  if (a.unconverged)
+    cerr << "Warning: " << a.unconverged
+         << " eigenvalues did not converge." << endl;
+
+  print_ensemble(args, a, print);
+}
+
+/**
+ * The cuts of the networks, for a replica, or merged for a number of
+ * replicas.
+ */
+struct cuts_acc
+{
+  // The number of bridges.
+  dbl_acc bridges;
+
+  // The number of articulation points.
+  dbl_acc articulations;
+
+  // The number of links added to make the network survivable.
+  dbl_acc added;
+
+  void
+  merge(const cuts_acc &a)
+  {
+    bridges.merge(a.bridges);
+    articulations.merge(a.articulations);
+    added.merge(a.added);
+  }
+};
+
+void
+cuts_stats(const cli_args &args)
+{
+  bool generated = args.inputs.empty();
+
+  auto print = [&](stats_printer &p, const cuts_acc &a)
+    {
+      print_stats(p, "Bridges", a.bridges);
+      print_stats(p, "Articulation points", a.articulations);
+      if (generated)
+        print_stats(p, "Added links", a.added);
+    };
+
+  // The graphs are not reordered, since the cuts don't depend on the
+  // order, and the generated graphs tell the links added.
+  cuts_acc a = run_ensemble<cuts_acc>
+    (generated ? args.replicas : args.inputs.size(), args.threads,
+     [&](int i)
+     {
+       cuts_acc a;
+       csr_graph g;
+
+       auto start = timer::now();
+       if (generated)
+         {
+           union_find uf;
+           graph gg = generate_graph(args, philox(args.seed, i), uf);
+           a.added(gg[boost::graph_bundle].added);
+           g = make_csr(gg);
+         }
+       else
+         g = input_graph(args, order_t::none, i);
+       double generation = elapsed(start);
+
+       start = timer::now();
+       cut_result r = find_cuts(g);
+       a.bridges(r.bridges.size());
+       a.articulations(r.articulations.size());
+       print_replica(args, i, generation, elapsed(start), a, print);
+
+       return a;
+     });
+
+  print_ensemble(args, a, print);
+}
+
+/**
+ * Answer the shortest-path queries on the first input graph, or on
+ * the first replica, with its contraction hierarchy if given.  The
+ * graph is not reordered, so that the queries refer to its nodes as
+ * they are.  The answers go to the standard output as they are
+ * found, and the summary to the standard error.
+ */
+void
+query_stats(const cli_args &args)
+{
+  csr_graph g;
+  if (args.inputs.empty())
+    {
+      union_find uf;
+      g = make_csr(generate_graph(args, philox(args.seed, 0), uf));
+    }
+  else
+    g = read_graph(args.inputs.front(), args.threads);
+
+  unique_ptr<ch_table> ch;
+  if (!args.ch.empty())
+    {
+      ch.reset(new ch_table(args.ch));
+      if (ch->checksum() != checksum(g))
+        throw runtime_error("The hierarchy '" + args.ch
+                            + "' is not of the graph.");
+    }
+
+  ifstream file;
+  if (args.queries != "-")
+    {
+      file.open(args.queries);
+      if (!file)
+        throw runtime_error("Cannot open the query file '"
+                            + args.queries + "'.");
+    }
+  else
+    ios::sync_with_stdio(false);
+  istream &in = args.queries == "-" ? cin : file;
+
+  query_summary s;
+  {
+    out_buffer out(STDOUT_FILENO);
+    s = answer_queries(g, ch.get(), in, out, args.threads);
+    out.flush();
+  }
+
+  stats_printer p(cerr, stats_format_interpret(args.stats_format));
+  p.begin();
+  p.start("Queries");
+  p.value("count", s.latency.count());
+  p.value("without a path", s.unreachable);
+  p.finish();
+
+  if (s.latency.count())
+    {
+      print_stats(p, "Latency [us]", s.latency);
+      print_stats(p, "Settled nodes", s.settled);
+
+      // The buckets of the histogram, from the first one used.
+      const auto &b = s.histogram.buckets;
+      size_t i = 0;
+      while (!b[i])
+        ++i;
+      p.start("Latency histogram [us]");
+      for (double upper = 1 << i; i < b.size(); ++i, upper *= 2)
+        p.value("< " + to_string(uint64_t(upper)), b[i]);
+      p.finish();
+    }
+  p.end();
 }
 
 int
 main(int argc, const char* argv[])
 {
   cli_args args = process_cli_args(argc, argv);
-  net_stats(args);
+
+  try
+    {
+      switch (analysis_interpret(args.mode))
+        {
+        case analysis_t::stats:
+          net_stats(args);
+          break;
+
+        case analysis_t::percolation:
+          percolation_stats(args);
+          break;
+
+        case analysis_t::betweenness:
+          betweenness_stats(args);
+          break;
+
+        case analysis_t::diameter:
+          eccentricity_stats(args, false);
+          break;
+
+        case analysis_t::eccentricity:
+          eccentricity_stats(args, true);
+          break;
+
+        case analysis_t::clustering:
+          clustering_stats(args);
+          break;
+
+        case analysis_t::spectrum:
+          spectrum_stats(args);
+          break;
+
+        case analysis_t::cuts:
+          cuts_stats(args);
+          break;
+
+        case analysis_t::query:
+          query_stats(args);
+          break;
+        }
+    }
+  catch (const std::exception &e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
     
   return 0;
 }
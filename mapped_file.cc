@@ -0,0 +1,47 @@
+#include "mapped_file.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+mapped_file::mapped_file(const string &path)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw system_error(errno, generic_category(), path);
+
+  struct stat st;
+  if (fstat(fd, &st) < 0)
+    {
+      int e = errno;
+      close(fd);
+      throw system_error(e, generic_category(), path);
+    }
+
+  m_size = st.st_size;
+
+  // An empty file cannot be mapped, and needs no mapping.
+  if (m_size)
+    {
+      void *addr = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+      int e = errno;
+      close(fd);
+      if (addr == MAP_FAILED)
+        throw system_error(e, generic_category(), path);
+      m_data = static_cast<const char *>(addr);
+    }
+  else
+    close(fd);
+}
+
+mapped_file::~mapped_file()
+{
+  if (m_size)
+    munmap(const_cast<char *>(m_data), m_size);
+}
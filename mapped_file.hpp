@@ -0,0 +1,38 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+/**
+ * The file mapped read-only into memory, and unmapped on
+ * destruction.  Throws std::system_error if the file cannot be
+ * opened or mapped.
+ */
+class mapped_file
+{
+  const char *m_data = nullptr;
+  std::size_t m_size = 0;
+
+public:
+  explicit mapped_file(const std::string &path);
+
+  ~mapped_file();
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  const char *
+  data() const
+  {
+    return m_data;
+  }
+
+  std::size_t
+  size() const
+  {
+    return m_size;
+  }
+};
+
+#endif /* MAPPED_FILE_HPP */
@@ -0,0 +1,67 @@
+#ifndef NAMES_HPP
+#define NAMES_HPP
+
+#include <cstddef>
+
+/**
+ * The names of the vertexes.  No names are stored: a name is
+ * formatted on demand from the vertex number, either as "v" followed
+ * by the number counted from 1 and zero-padded to the width of the
+ * largest number (e.g., "v007" in a graph of 100 vertexes), or as the
+ * bare vertex number counted from 0.
+ */
+class vertex_names
+{
+  // The number of digits, or 0 for the bare numbers.
+  int m_width;
+
+public:
+  /// The maximal length of a name.
+  static constexpr int max_size = 24;
+
+  vertex_names(std::size_t n, bool bare):
+    m_width(0)
+  {
+    if (!bare)
+      for (m_width = 1; n >= 10; n /= 10)
+        ++m_width;
+  }
+
+  bool
+  bare() const
+  {
+    return !m_width;
+  }
+
+  /**
+   * Write the name of vertex v at first, which needs room for
+   * max_size characters.
+   *
+   * @return the end of the name written
+   */
+  char *
+  format(char *first, std::size_t v) const
+  {
+    char digits[max_size];
+    char *p = digits + max_size;
+
+    std::size_t number = m_width ? v + 1 : v;
+    do
+      *--p = '0' + number % 10;
+    while (number /= 10);
+
+    if (m_width)
+      {
+        *first++ = 'v';
+        for (int i = digits + max_size - p; i < m_width; ++i)
+          *first++ = '0';
+      }
+
+    while (p != digits + max_size)
+      *first++ = *p++;
+
+    return first;
+  }
+};
+
+#endif /* NAMES_HPP */
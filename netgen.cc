@@ -1,23 +1,357 @@
+#include "async_writer.hpp"
+#include "batch.hpp"
+#include "bin_graph.hpp"
+#include "dot.hpp"
+#include "edge_pipe.hpp"
+#include "formats.hpp"
 #include "generate.hpp"
+#include "gzip_filter.hpp"
 #include "graph.hpp"
 #include "cli_args.hpp"
+#include "contract.hpp"
+#include "names.hpp"
+#include "order.hpp"
+#include "out_buffer.hpp"
+#include "parallel.hpp"
+#include "paths.hpp"
+#include "routes.hpp"
+#include "stream_random.hpp"
 #include "utils.hpp"
 
-#include <boost/graph/graphviz.hpp>
-
+#include <future>
 #include <iostream>
-#include <random>
+#include <memory>
+
+#include <unistd.h>
+
+/**
+ * Call f with the buffer to format the text into: the output buffer
+ * itself, or the buffer of the gzip stage in front of it.  The output
+ * buffer is flushed at the end.
+ */
+template <typename F>
+void
+format_to(out_buffer &out, bool gzip, F f)
+{
+  if (gzip)
+    {
+      gzip_filter gz(out);
+      {
+        out_buffer text(gz);
+        f(text);
+        text.flush();
+      }
+      gz.finish();
+    }
+  else
+    f(out);
+
+  out.flush();
+}
+
+// Write the graph in the requested format.
+void
+write_graph(out_buffer &out, const graph &g, const cli_args &args,
+            csr_builder &b)
+{
+  vertex_names names(num_vertices(g), args.bare_ids);
+
+  format_to(out, args.gzip, [&](out_buffer &text)
+    {
+      switch (format_interpret(args.format))
+        {
+        case format_t::dot:
+          write_dot(text, g, names);
+          break;
+
+        case format_t::bin:
+          write_bin(text, make_csr(g, b), args.bin_names ? &names : nullptr);
+          break;
+
+        case format_t::edges:
+          write_edges(text, g, names);
+          break;
+
+        case format_t::metis:
+          write_metis(text, make_csr(g, b));
+          break;
+
+        case format_t::graphml:
+          write_graphml(text, g, names);
+          break;
+        }
+    });
+}
+
+/**
+ * Write the file with the writer: f writes into the output buffer.
+ */
+template <typename F>
+void
+write_file(async_writer &writer, const string &path, F f)
+{
+  int fd = writer.open(path);
+  {
+    out_buffer out(writer, fd);
+    f(out);
+    out.flush();
+  }
+  writer.close(fd);
+}
+
+/**
+ * Write the path table, the route table and the contraction
+ * hierarchy of the graph, if asked for, to their files with the
+ * writer.
+ */
+void
+write_tables(async_writer &writer, const graph &g, const cli_args &args,
+             const philox &eng)
+{
+  if (args.paths.empty() && args.routes.empty() && args.ch.empty())
+    return;
+
+  csr_graph c = make_csr(g);
+
+  if (!args.paths.empty())
+    {
+      path_set s = find_paths(c, args.k_paths, args.pairs, args.threads,
+                              eng);
+      write_file(writer, args.paths, [&](out_buffer &out)
+        {
+          write_paths(out, c.nr_vertices(), args.k_paths, s);
+        });
+    }
+
+  if (!args.routes.empty())
+    {
+      route_set s = find_routes(c, args.threads);
+      write_file(writer, args.routes, [&](out_buffer &out)
+        {
+          write_routes(out, s);
+        });
+    }
+
+  if (!args.ch.empty())
+    {
+      ch_set s = contract(c, args.threads);
+      write_file(writer, args.ch, [&](out_buffer &out)
+        {
+          write_ch(out, s);
+        });
+    }
+}
+
+/**
+ * Generate the graphs of the batch on the pool of threads, every
+ * graph to its file.  The threads generate and format the graphs, and
+ * the writer thread writes them, so that the disk is kept busy.  A
+ * thread reuses its output buffer, its CSR builder and its union-find
+ * for the graphs it generates.
+ */
+void
+run_batch(const cli_args &args)
+{
+  batch b = read_batch(args.batch, args);
+  format_interpret(args.format);
+  order_t order = order_interpret(args.order);
+
+  unsigned threads = nr_threads(args.threads);
+  async_writer writer(2 * threads + 1);
+  std::vector<std::unique_ptr<out_buffer>> outs(threads);
+  std::vector<csr_builder> builders(threads);
+  std::vector<union_find> ufs(threads);
+
+  parallel_for(b.jobs.size(), threads, [&](size_t i, unsigned t)
+    {
+      const cli_args &job = b.jobs[i];
+      graph g = reorder(generate_graph(job, philox(job.seed), ufs[t]),
+                        order);
+      int fd = writer.open(batch_path(b.output, job, num_edges(g)));
+
+      if (!outs[t])
+        outs[t].reset(new out_buffer(writer, fd));
+      else
+        outs[t]->rebind(fd);
+
+      write_graph(*outs[t], g, job, builders[t]);
+      writer.close(fd);
+    });
+
+  outs.clear();
+  writer.finish();
+}
+
+/**
+ * Generate the random network in one thread, and format it in
+ * another, while the writer thread writes the text.
+ */
+void
+run_stream(const cli_args &args, const philox &eng)
+{
+  edge_pipe pipe;
+
+  auto generator = std::async(std::launch::async, [&]
+    {
+      try
+        {
+          stream_random_graph(args, eng, pipe);
+        }
+      catch (const edge_pipe::cancelled &)
+        {
+        }
+      catch (...)
+        {
+          // Let the writer side stop, and report the error with get().
+          pipe.cancel();
+          throw;
+        }
+    });
+
+  vertex_names names(args.nr_nodes, args.bare_ids);
+  async_writer writer;
+  {
+    out_buffer out(writer, STDOUT_FILENO);
+    format_to(out, args.gzip, [&](out_buffer &text)
+      {
+        switch (format_interpret(args.format))
+          {
+          case format_t::dot:
+            {
+              dot_writer w(text, names);
+              pipe.drain(w);
+              break;
+            }
+
+          case format_t::edges:
+            {
+              edges_writer w(text, names);
+              pipe.drain(w);
+              break;
+            }
+
+          case format_t::graphml:
+            {
+              graphml_writer w(text, names);
+              pipe.drain(w);
+              break;
+            }
+
+          default:
+            abort();
+          }
+      });
+  }
+  generator.get();
+  writer.finish();
+}
 
 int
 main(int argc, const char* argv[])
 {
   cli_args args = process_cli_args(argc, argv);
-  default_random_engine eng;
-  eng.seed(args.seed);
-  graph g = generate_graph(args, eng);
-  
-  boost::dynamic_properties dp;
-  dp.property("node_id", get(boost::vertex_name, g));
-  dp.property("weight", get(boost::edge_weight, g));
-  write_graphviz_dp(cout, g, dp);
+
+  try
+    {
+      if (args.gzip && format_interpret(args.format) == format_t::bin)
+        {
+          cerr << "Option 'gzip' cannot compress the binary format, "
+               << "which is mapped in place." << endl;
+          return 1;
+        }
+
+      if (!args.batch.empty())
+        {
+          if (!args.paths.empty() || !args.routes.empty() ||
+              !args.ch.empty())
+            {
+              cerr << "Option 'batch' cannot write the path or the "
+                   << "route table, or the hierarchy." << endl;
+              return 1;
+            }
+
+          if (args.stream)
+            {
+              cerr << "Option 'batch' cannot stream the edges." << endl;
+              return 1;
+            }
+
+          run_batch(args);
+          return 0;
+        }
+
+      if (args.nt.empty())
+        {
+          cerr << "Option 'nt' is required." << endl;
+          return 1;
+        }
+
+      philox eng(args.seed);
+
+      // Stream the edges straight to the output.
+      if (args.stream)
+        {
+          format_t format = format_interpret(args.format);
+          if (nt_interpret(args.nt) != nt_t::random_network ||
+              format == format_t::bin || format == format_t::metis)
+            {
+              cerr << "Option 'stream' requires the random network "
+                   << "in dot, edges or graphml." << endl;
+              return 1;
+            }
+
+          if (order_interpret(args.order) != order_t::none)
+            {
+              cerr << "Option 'stream' cannot reorder the vertexes."
+                   << endl;
+              return 1;
+            }
+
+          if (survivable_interpret(args.survivable) != survivable_t::none)
+            {
+              cerr << "Option 'stream' cannot make the network survivable."
+                   << endl;
+              return 1;
+            }
+
+          if (!args.paths.empty() || !args.routes.empty() ||
+              !args.ch.empty())
+            {
+              cerr << "Option 'stream' cannot write the path or the "
+                   << "route table, or the hierarchy." << endl;
+              return 1;
+            }
+
+          run_stream(args, eng);
+          return 0;
+        }
+
+      union_find uf;
+      graph g = reorder(generate_graph(args, eng, uf),
+                        order_interpret(args.order));
+      if (uf.count() > 1)
+        cerr << "The network has " << uf.count()
+             << " connected components." << endl;
+
+      if (survivable_interpret(args.survivable) != survivable_t::none)
+        cerr << "Added " << g[boost::graph_bundle].added
+             << " links to make the network survivable." << endl;
+
+      // Format the graph, while the writer thread writes it.
+      async_writer writer;
+      {
+        out_buffer out(writer, STDOUT_FILENO);
+        csr_builder b;
+        write_graph(out, g, args, b);
+      }
+
+      write_tables(writer, g, args, eng);
+
+      writer.finish();
+    }
+  catch (const std::exception &e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
 }
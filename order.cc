@@ -0,0 +1,308 @@
+#include "order.hpp"
+
+#include <boost/range.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+typedef csr_graph::vertex_type vertex_type;
+
+namespace
+{
+  /**
+   * The distance along the Hilbert curve of order 16, which fills the
+   * grid of 2^16 x 2^16 cells, to the cell (x, y).
+   */
+  uint64_t
+  hilbert_index(uint32_t x, uint32_t y)
+  {
+    uint64_t d = 0;
+
+    for (uint32_t s = 1 << 15; s; s >>= 1)
+      {
+        uint32_t rx = (x & s) != 0;
+        uint32_t ry = (y & s) != 0;
+        d += uint64_t(s) * s * ((3 * rx) ^ ry);
+
+        // Rotate the quadrant.
+        if (!ry)
+          {
+            if (rx)
+              {
+                x = s - 1 - x;
+                y = s - 1 - y;
+              }
+            swap(x, y);
+          }
+      }
+
+    return d;
+  }
+
+  vector<vertex_type>
+  hilbert_order(const csr_graph &g)
+  {
+    const location *l = g.locations();
+    if (!l)
+      throw runtime_error("The hilbert order requires the vertex "
+                          "locations.");
+
+    vertex_type n = g.nr_vertices();
+    if (!n)
+      return {};
+
+    double min_x = l[0].x, max_x = l[0].x;
+    double min_y = l[0].y, max_y = l[0].y;
+    for (vertex_type v = 1; v < n; ++v)
+      {
+        min_x = min(min_x, l[v].x);
+        max_x = max(max_x, l[v].x);
+        min_y = min(min_y, l[v].y);
+        max_y = max(max_y, l[v].y);
+      }
+
+    // Scale the bounding box to the grid, keeping the aspect ratio.
+    double side = max(max_x - min_x, max_y - min_y);
+    double scale = side > 0 ? 65535 / side : 0;
+
+    vector<pair<uint64_t, vertex_type>> keys(n);
+    for (vertex_type v = 0; v < n; ++v)
+      keys[v] = make_pair(hilbert_index((l[v].x - min_x) * scale,
+                                        (l[v].y - min_y) * scale), v);
+    sort(keys.begin(), keys.end());
+
+    vector<vertex_type> order(n);
+    for (vertex_type i = 0; i < n; ++i)
+      order[i] = keys[i].second;
+
+    return order;
+  }
+
+  /**
+   * The breadth-first search from the root, which appends the visited
+   * vertexes to the queue, taking the neighbors by increasing degree.
+   *
+   * @param last set to the position in the queue of the last level
+   * @return the number of the levels
+   */
+  size_t
+  bfs(const csr_graph &g, vertex_type root, vector<vertex_type> &queue,
+      vector<char> &visited, size_t &last)
+  {
+    size_t levels = 0;
+
+    last = queue.size();
+    queue.push_back(root);
+    visited[root] = true;
+
+    for (size_t i = last, level_end = last; i < queue.size(); ++i)
+      {
+        if (i == level_end)
+          {
+            ++levels;
+            last = i;
+            level_end = queue.size();
+          }
+
+        size_t children = queue.size();
+        vertex_type v = queue[i];
+        for (auto a = g.offset(v); a < g.offset(v + 1); ++a)
+          {
+            vertex_type t = g.targets()[a];
+            if (!visited[t])
+              {
+                visited[t] = true;
+                queue.push_back(t);
+              }
+          }
+
+        stable_sort(queue.begin() + children, queue.end(),
+                    [&g](vertex_type a, vertex_type b)
+                    {return g.degree(a) < g.degree(b);});
+      }
+
+    return levels;
+  }
+
+  vector<vertex_type>
+  rcm_order(const csr_graph &g)
+  {
+    vertex_type n = g.nr_vertices();
+
+    // The vertexes by increasing degree, to start the components.
+    vector<vertex_type> by_degree(n);
+    iota(by_degree.begin(), by_degree.end(), 0);
+    stable_sort(by_degree.begin(), by_degree.end(),
+                [&g](vertex_type a, vertex_type b)
+                {return g.degree(a) < g.degree(b);});
+
+    vector<vertex_type> order;
+    order.reserve(n);
+    vector<char> visited(n, false);
+    vector<vertex_type> scratch;
+
+    for (vertex_type s: by_degree)
+      {
+        if (visited[s])
+          continue;
+
+        // Look for a peripheral vertex (George and Liu): go to the
+        // vertex of the lowest degree in the last level, while the
+        // eccentricity grows.
+        vertex_type root = s;
+        size_t last, ecc = 0;
+        while (true)
+          {
+            scratch.clear();
+            size_t e = bfs(g, root, scratch, visited, last);
+            for (vertex_type v: scratch)
+              visited[v] = false;
+
+            if (e <= ecc)
+              break;
+            ecc = e;
+
+            root = *min_element(scratch.begin() + last, scratch.end(),
+                                [&g](vertex_type a, vertex_type b)
+                                {return g.degree(a) < g.degree(b);});
+          }
+
+        bfs(g, root, order, visited, last);
+      }
+
+    reverse(order.begin(), order.end());
+    return order;
+  }
+
+  vector<vertex_type>
+  degree_order(const csr_graph &g)
+  {
+    vector<vertex_type> order(g.nr_vertices());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(),
+                [&g](vertex_type a, vertex_type b)
+                {return g.degree(a) > g.degree(b);});
+    return order;
+  }
+}
+
+vector<vertex_type>
+vertex_order(const csr_graph &g, order_t order)
+{
+  vertex_type n = g.nr_vertices();
+  vector<vertex_type> old_id;
+
+  switch (order)
+    {
+    case order_t::none:
+      old_id.resize(n);
+      iota(old_id.begin(), old_id.end(), 0);
+      break;
+
+    case order_t::hilbert:
+      old_id = hilbert_order(g);
+      break;
+
+    case order_t::rcm:
+      old_id = rcm_order(g);
+      break;
+
+    case order_t::degree:
+      old_id = degree_order(g);
+      break;
+    }
+
+  assert(old_id.size() == n);
+
+  vector<vertex_type> new_id(n);
+  for (vertex_type i = 0; i < n; ++i)
+    new_id[old_id[i]] = i;
+
+  return new_id;
+}
+
+csr_graph
+permute(const csr_graph &g, const vector<vertex_type> &new_id)
+{
+  vertex_type n = g.nr_vertices();
+  assert(new_id.size() == n);
+
+  vector<vertex_type> old_id(n);
+  for (vertex_type v = 0; v < n; ++v)
+    old_id[new_id[v]] = v;
+
+  vector<uint64_t> offsets(n + 1, 0);
+  for (vertex_type v = 0; v < n; ++v)
+    offsets[v + 1] = offsets[v] + g.degree(old_id[v]);
+
+  vector<uint32_t> targets(g.nr_arcs());
+  vector<COST> weights(g.nr_arcs());
+  vector<pair<uint32_t, COST>> arcs;
+
+  // Renumber the targets, and sort the arcs by them again.
+  for (vertex_type v = 0; v < n; ++v)
+    {
+      vertex_type o = old_id[v];
+      arcs.clear();
+      for (auto a = g.offset(o); a < g.offset(o + 1); ++a)
+        arcs.emplace_back(new_id[g.targets()[a]], g.weights()[a]);
+      sort(arcs.begin(), arcs.end());
+
+      for (size_t i = 0; i < arcs.size(); ++i)
+        {
+          targets[offsets[v] + i] = arcs[i].first;
+          weights[offsets[v] + i] = arcs[i].second;
+        }
+    }
+
+  vector<location> locations;
+  if (g.locations())
+    {
+      locations.resize(n);
+      for (vertex_type v = 0; v < n; ++v)
+        locations[v] = g.locations()[old_id[v]];
+    }
+
+  return csr_graph(move(offsets), move(targets), move(weights),
+                   move(locations));
+}
+
+graph
+permute(const graph &g, const vector<vertex_type> &new_id)
+{
+  vertex_type n = num_vertices(g);
+  assert(new_id.size() == n);
+
+  vector<vertex_type> old_id(n);
+  for (vertex_type v = 0; v < n; ++v)
+    old_id[new_id[v]] = v;
+
+  graph h(n);
+  h[boost::graph_bundle] = g[boost::graph_bundle];
+  for (vertex_type v = 0; v < n; ++v)
+    h[v] = g[old_id[v]];
+
+  vector<pair<vertex_type, COST>> arcs;
+
+  for (vertex_type u = 0; u < n; ++u)
+    {
+      arcs.clear();
+      for (edge e: boost::make_iterator_range(out_edges(old_id[u], g)))
+        {
+          vertex_type v = new_id[target(e, g)];
+          if (u < v)
+            arcs.emplace_back(v, boost::get(boost::edge_weight, g, e));
+        }
+      sort(arcs.begin(), arcs.end());
+
+      for (const auto &a: arcs)
+        add_edge(u, a.first, a.second, h);
+    }
+
+  return h;
+}
@@ -0,0 +1,72 @@
+#ifndef ORDER_HPP
+#define ORDER_HPP
+
+#include "cli_args.hpp"
+#include "csr_graph.hpp"
+#include "graph.hpp"
+
+#include <vector>
+
+/**
+ * The new numbers of the vertexes in the requested order, so that
+ * the vertexes close in the graph get close numbers, and their data
+ * close in memory:
+ *
+ * - hilbert: along the Hilbert curve through the vertex locations,
+ *   for the geometric graphs only,
+ *
+ * - rcm: the reverse Cuthill-McKee order, which is the breadth-first
+ *   order from a peripheral vertex, with the neighbors taken by
+ *   increasing degree, and then reversed,
+ *
+ * - degree: by decreasing degree, so that the hubs come together.
+ *
+ * Throws std::runtime_error if the Hilbert order is requested for a
+ * graph without the locations.
+ *
+ * @return new_id[v] is the new number of vertex v
+ */
+std::vector<csr_graph::vertex_type>
+vertex_order(const csr_graph &g, order_t order);
+
+/**
+ * The CSR graph with the vertexes renumbered: the old vertex v is the
+ * new vertex new_id[v].  The locations are carried over, but not the
+ * names.
+ */
+csr_graph
+permute(const csr_graph &g,
+        const std::vector<csr_graph::vertex_type> &new_id);
+
+/**
+ * The graph with the vertexes renumbered.  The edges are added in the
+ * order of their new end vertexes.
+ */
+graph
+permute(const graph &g, const std::vector<csr_graph::vertex_type> &new_id);
+
+/**
+ * Renumber the vertexes of the CSR graph in the requested order.
+ */
+inline csr_graph
+reorder(const csr_graph &g, order_t order)
+{
+  if (order == order_t::none)
+    return g;
+
+  return permute(g, vertex_order(g, order));
+}
+
+/**
+ * Renumber the vertexes of the graph in the requested order.
+ */
+inline graph
+reorder(graph g, order_t order)
+{
+  if (order == order_t::none)
+    return g;
+
+  return permute(g, vertex_order(make_csr(g), order));
+}
+
+#endif /* ORDER_HPP */
@@ -0,0 +1,100 @@
+#include "out_buffer.hpp"
+
+#include "async_writer.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+#include <unistd.h>
+
+using namespace std;
+
+out_buffer::out_buffer(int fd, size_t size):
+  m_fd(fd), m_buf(size), m_pos(m_buf.data()),
+  m_end(m_buf.data() + m_buf.size())
+{
+}
+
+out_buffer::out_buffer(async_writer &writer, int fd):
+  m_fd(fd), m_writer(&writer), m_buf(writer.buffer()),
+  m_pos(m_buf.data()), m_end(m_buf.data() + m_buf.size())
+{
+}
+
+out_buffer::out_buffer(out_filter &filter, size_t size):
+  m_fd(-1), m_filter(&filter), m_buf(size), m_pos(m_buf.data()),
+  m_end(m_buf.data() + m_buf.size())
+{
+}
+
+out_buffer::~out_buffer()
+{
+  try
+    {
+      flush();
+    }
+  catch (const system_error &)
+    {
+    }
+
+  // Give the buffer back to the writer.
+  if (m_writer)
+    m_writer->recycle(move(m_buf));
+}
+
+void
+out_buffer::flush()
+{
+  if (m_pos == m_buf.data())
+    return;
+
+  size_t n = m_pos - m_buf.data();
+  // Drop the buffered text, so that we don't retry after an error.
+  m_pos = m_buf.data();
+
+  if (m_writer)
+    {
+      vector<char> full = move(m_buf);
+      m_buf = m_writer->buffer();
+      m_pos = m_buf.data();
+      m_end = m_buf.data() + m_buf.size();
+      m_writer->write(m_fd, move(full), n);
+    }
+  else if (m_filter)
+    m_filter->write(m_buf.data(), n);
+  else
+    write_all(m_fd, m_buf.data(), n);
+}
+
+void
+out_buffer::grow(size_t n)
+{
+  flush();
+
+  // A single piece larger than the buffer gets a larger buffer.
+  if (m_buf.size() < n)
+    {
+      m_buf.resize(n);
+      m_pos = m_buf.data();
+      m_end = m_buf.data() + m_buf.size();
+    }
+}
+
+void
+write_all(int fd, const char *p, size_t n)
+{
+  while (n)
+    {
+      ssize_t r = ::write(fd, p, n);
+
+      if (r < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          throw system_error(errno, generic_category(), "write");
+        }
+
+      p += r;
+      n -= r;
+    }
+}
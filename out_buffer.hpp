@@ -0,0 +1,166 @@
+#ifndef OUT_BUFFER_HPP
+#define OUT_BUFFER_HPP
+
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+class async_writer;
+
+/**
+ * The stage the buffered text goes through on its way out, e.g., the
+ * compression.
+ */
+class out_filter
+{
+public:
+  virtual
+  ~out_filter() = default;
+
+  /// Take the n characters.
+  virtual void
+  write(const char *p, std::size_t n) = 0;
+};
+
+/**
+ * The output buffer.  The text is formatted straight into a large
+ * buffer, and a full buffer is written to the file descriptor with a
+ * single write() call.
+ *
+ * The buffer has to be flushed explicitly, since a write error is
+ * reported with an exception (std::system_error).  The destructor
+ * flushes whatever is left, but ignores the errors.
+ *
+ * With an asynchronous writer, a full buffer is queued for writing,
+ * and the formatting goes on in a free buffer taken from the writer.
+ * With a filter, the buffered text is passed to the filter instead.
+ */
+class out_buffer
+{
+public:
+  explicit out_buffer(int fd, std::size_t size = 1 << 20);
+
+  /// Write to the file descriptor with the asynchronous writer.
+  out_buffer(async_writer &writer, int fd);
+
+  /// Pass the text to the filter.
+  explicit out_buffer(out_filter &filter, std::size_t size = 1 << 20);
+
+  ~out_buffer();
+
+  out_buffer(const out_buffer &) = delete;
+  out_buffer &operator=(const out_buffer &) = delete;
+
+  /**
+   * Make room for n characters, and return where to write them.  The
+   * written characters are then committed with commit().
+   */
+  char *
+  reserve(std::size_t n)
+  {
+    if (std::size_t(m_end - m_pos) < n)
+      grow(n);
+    return m_pos;
+  }
+
+  /// Commit the characters written up to the given end.
+  void
+  commit(char *end)
+  {
+    m_pos = end;
+  }
+
+  void
+  put(char c)
+  {
+    *reserve(1) = c;
+    ++m_pos;
+  }
+
+  void
+  put(const char *s, std::size_t n)
+  {
+    std::memcpy(reserve(n), s, n);
+    m_pos += n;
+  }
+
+  void
+  put(const char *s)
+  {
+    put(s, std::strlen(s));
+  }
+
+  /// Write an integer in decimal.
+  template <typename T>
+  void
+  put_int(T x)
+  {
+    char *p = reserve(24);
+    m_pos = std::to_chars(p, p + 24, x).ptr;
+  }
+
+  /// Write all the buffered characters to the file descriptor.
+  void
+  flush();
+
+  /// Flush, and go on writing to another file descriptor.
+  void
+  rebind(int fd)
+  {
+    flush();
+    m_fd = fd;
+  }
+
+private:
+  // Flush, and make sure there is room for n characters.
+  void
+  grow(std::size_t n);
+
+  int m_fd;
+  async_writer *m_writer = nullptr;
+  out_filter *m_filter = nullptr;
+  std::vector<char> m_buf;
+  char *m_pos;
+  char *m_end;
+};
+
+/**
+ * Write the n characters to the file descriptor, retrying the
+ * interrupted and the partial writes.  Throws std::system_error.
+ */
+void
+write_all(int fd, const char *p, std::size_t n);
+
+/**
+ * Format a double the way an std::ostream with the default settings
+ * does (like printf's %g), which is how the Boost dynamic properties
+ * turn the values into strings.  It keeps 6 significant digits only,
+ * and is used where the output has to match that of Boost.
+ *
+ * @return the end of the formatted number
+ */
+inline char *
+format_double(char *first, char *last, double x)
+{
+  return std::to_chars(first, last, x, std::chars_format::general, 6).ptr;
+}
+
+/**
+ * Format a double exactly: as an integer if it is one, like the
+ * weights of the generated networks, or else in the shortest form
+ * that reads back as the same double.
+ *
+ * @return the end of the formatted number
+ */
+inline char *
+format_exact(char *first, char *last, double x)
+{
+  if (x == std::trunc(x) && std::fabs(x) < 1e18)
+    return std::to_chars(first, last, std::int64_t(x)).ptr;
+  return std::to_chars(first, last, x).ptr;
+}
+
+#endif /* OUT_BUFFER_HPP */
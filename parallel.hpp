@@ -0,0 +1,204 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * The number of threads to use: the requested number, or the number
+ * of hardware threads if zero was requested.
+ */
+inline unsigned
+nr_threads(unsigned requested)
+{
+  if (requested)
+    return requested;
+
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Call f(i, t) for i = 0, ..., n - 1 on a pool of threads, where t is
+ * the number of the thread (from 0 to threads - 1) that runs the
+ * call.  The indexes are handed out one at a time, so that the
+ * threads are kept busy even if the calls take different times.  The
+ * first exception thrown by f is rethrown in the calling thread.
+ */
+template <typename F>
+void
+parallel_for(std::size_t n, unsigned threads, F f)
+{
+  threads = std::min<std::size_t>(nr_threads(threads), n);
+
+  std::atomic<std::size_t> next(0);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto worker = [&](unsigned t)
+    {
+      try
+        {
+          for (std::size_t i; (i = next++) < n;)
+            f(i, t);
+        }
+      catch (...)
+        {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error)
+            error = std::current_exception();
+          // Make the other threads stop.
+          next = n;
+        }
+    };
+
+  if (threads <= 1)
+    worker(0);
+  else
+    {
+      std::vector<std::thread> pool;
+      for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker, t);
+      worker(0);
+      for (auto &th: pool)
+        th.join();
+    }
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+/**
+ * The pool of threads for the loops that are run many times, each
+ * too short to start the threads anew, like the vector operations of
+ * an iterative solver.  The threads are started once, and wait for
+ * the next loop in between.  A loop is run like with parallel_for,
+ * with the calling thread as thread 0.
+ */
+class thread_pool
+{
+public:
+  /// Start the pool of the given number of threads (see nr_threads).
+  explicit thread_pool(unsigned threads):
+    m_size(nr_threads(threads))
+  {
+    for (unsigned t = 1; t < m_size; ++t)
+      m_threads.emplace_back(&thread_pool::wait, this, t);
+  }
+
+  ~thread_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_start.notify_all();
+    for (auto &th: m_threads)
+      th.join();
+  }
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  unsigned
+  size() const
+  {
+    return m_size;
+  }
+
+  /// Call f(i, t) for i = 0, ..., n - 1 on the threads of the pool,
+  /// like parallel_for does, and wait for the calls to finish.
+  template <typename F>
+  void
+  run(std::size_t n, F f)
+  {
+    m_f = std::ref(f);
+    m_n = n;
+    m_next = 0;
+    m_error = nullptr;
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_busy = m_threads.size();
+      ++m_loop;
+    }
+    m_start.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] {return !m_busy;});
+    if (m_error)
+      std::rethrow_exception(m_error);
+  }
+
+private:
+  // Take the indexes of the loop as thread t.
+  void
+  work(unsigned t)
+  {
+    try
+      {
+        for (std::size_t i; (i = m_next++) < m_n;)
+          m_f(i, t);
+      }
+    catch (...)
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_error)
+          m_error = std::current_exception();
+        // Make the other threads stop.
+        m_next = m_n;
+      }
+  }
+
+  // Run the loops as thread t until stopped.
+  void
+  wait(unsigned t)
+  {
+    std::uint64_t loop = 0;
+    while (true)
+      {
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_start.wait(lock, [&] {return m_stop || m_loop != loop;});
+          if (m_stop)
+            return;
+          loop = m_loop;
+        }
+
+        work(t);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!--m_busy)
+          m_done.notify_one();
+      }
+  }
+
+  unsigned m_size;
+  std::vector<std::thread> m_threads;
+
+  // The loop: the calls, their number, and the next index.
+  std::function<void(std::size_t, unsigned)> m_f;
+  std::size_t m_n = 0;
+  std::atomic<std::size_t> m_next{0};
+  std::exception_ptr m_error;
+
+  // The number of the loop, the threads still running it, and if the
+  // pool stops, guarded by the mutex.
+  std::mutex m_mutex;
+  std::condition_variable m_start;
+  std::condition_variable m_done;
+  std::uint64_t m_loop = 0;
+  std::size_t m_busy = 0;
+  bool m_stop = false;
+};
+
+#endif /* PARALLEL_HPP */
@@ -0,0 +1,110 @@
+#include "path_table.hpp"
+#include "bin_graph.hpp"
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+static const char path_magic[8] = {'N', 'G', 'P', 'A', 'T', 'H', 'S', 0};
+
+void
+write_paths(out_buffer &out, uint64_t n, uint32_t k, const path_set &s)
+{
+  uint64_t p = s.nr_paths();
+
+  path_header h = {};
+  memcpy(h.magic, path_magic, sizeof(h.magic));
+  h.version = path_version;
+  h.byte_order = 0x01020304;
+  h.nr_vertices = n;
+  h.nr_pairs = s.pairs.size();
+  h.nr_paths = p;
+  h.nr_hops = s.vertexes.size();
+  h.k = k;
+
+  uint64_t pos = align8(sizeof(path_header));
+  h.pairs = pos;
+  pos += align8(h.nr_pairs * sizeof(path_pair));
+  h.offsets = pos;
+  pos += align8((p + 1) * sizeof(uint64_t));
+  h.costs = pos;
+  pos += align8(p * sizeof(COST));
+  h.vertexes = pos;
+  pos += align8(h.nr_hops * sizeof(uint32_t));
+  h.size = pos;
+
+  put_array(out, &h, 1);
+  put_array(out, s.pairs.data(), h.nr_pairs);
+  put_array(out, s.offsets.data(), p + 1);
+  put_array(out, s.costs.data(), p);
+  put_array(out, s.vertexes.data(), h.nr_hops);
+}
+
+path_table::path_table(const string &path):
+  m_file(make_shared<mapped_file>(path))
+{
+  const char *base = m_file->data();
+
+  try
+    {
+      const path_header &h = check_header<path_header>
+        (base, m_file->size(), path_magic, path_version,
+         "path table");
+      if (h.nr_vertices >= UINT32_MAX || h.nr_pairs > h.size ||
+          h.nr_paths > h.size || h.nr_hops > h.size)
+        throw runtime_error("bad table size");
+
+      uint64_t p = h.nr_paths;
+      check_section(sizeof(h), h.size, h.pairs,
+                    h.nr_pairs * sizeof(path_pair), "pairs");
+      check_section(sizeof(h), h.size, h.offsets,
+                    (p + 1) * sizeof(uint64_t), "offsets");
+      check_section(sizeof(h), h.size, h.costs, p * sizeof(COST), "costs");
+      check_section(sizeof(h), h.size, h.vertexes,
+                    h.nr_hops * sizeof(uint32_t), "vertexes");
+
+      m_h = &h;
+      m_pairs = reinterpret_cast<const path_pair *>(base + h.pairs);
+      m_offsets = reinterpret_cast<const uint64_t *>(base + h.offsets);
+      m_costs = reinterpret_cast<const COST *>(base + h.costs);
+      m_vertexes = reinterpret_cast<const uint32_t *>(base + h.vertexes);
+
+      check_offsets(m_offsets, p, h.nr_hops, "offsets");
+      check_indexes(m_vertexes, h.nr_hops, h.nr_vertices, "vertexes");
+
+      // The pairs have to be sorted for find(), and their paths have
+      // to be in the table.
+      for (uint64_t i = 0; i < h.nr_pairs; ++i)
+        {
+          const path_pair &q = m_pairs[i];
+          if (q.src >= q.dst || q.dst >= h.nr_vertices ||
+              (i && make_pair(m_pairs[i - 1].src, m_pairs[i - 1].dst) >=
+               make_pair(q.src, q.dst)))
+            throw runtime_error("bad pairs");
+          if (q.first > p || uint64_t(q.shortest) + q.disjoint > p - q.first)
+            throw runtime_error("bad pair paths");
+        }
+    }
+  catch (const runtime_error &e)
+    {
+      throw runtime_error(path + ": " + e.what());
+    }
+}
+
+const path_pair *
+path_table::find(uint32_t u, uint32_t v) const
+{
+  if (u > v)
+    swap(u, v);
+
+  const path_pair *e = m_pairs + m_h->nr_pairs;
+  const path_pair *i =
+    lower_bound(m_pairs, e, make_pair(u, v),
+                [](const path_pair &p, const pair<uint32_t, uint32_t> &x)
+                {return make_pair(p.src, p.dst) < x;});
+
+  return i != e && i->src == u && i->dst == v ? i : nullptr;
+}
@@ -0,0 +1,188 @@
+#ifndef PATH_TABLE_HPP
+#define PATH_TABLE_HPP
+
+#include "graph.hpp"
+#include "out_buffer.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class mapped_file;
+
+/**
+ * The node pair of the path table, with src < dst.  The paths of the
+ * pair start at path number first: the k shortest paths in the
+ * nondecreasing order of their length, and then the two
+ * edge-disjoint paths, if the pair has them.  A path goes from src to
+ * dst; the path from dst to src is its reverse.
+ */
+struct path_pair
+{
+  std::uint32_t src;
+  std::uint32_t dst;
+  // The number of the shortest paths.
+  std::uint32_t shortest;
+  // The number of the disjoint paths: 0 or 2.
+  std::uint32_t disjoint;
+  // The number of the first path.
+  std::uint64_t first;
+};
+
+/**
+ * The paths of the node pairs, sorted by src and dst.  Path i goes
+ * through the vertexes from offsets[i] to offsets[i + 1] of
+ * vertexes, and has length costs[i].
+ */
+struct path_set
+{
+  std::vector<path_pair> pairs;
+  std::vector<std::uint64_t> offsets = {0};
+  std::vector<COST> costs;
+  std::vector<std::uint32_t> vertexes;
+
+  /// Add the path of the vertexes from b to e.
+  void
+  add(const std::uint32_t *b, const std::uint32_t *e, COST cost)
+  {
+    vertexes.insert(vertexes.end(), b, e);
+    offsets.push_back(vertexes.size());
+    costs.push_back(cost);
+  }
+
+  /// The number of the paths.
+  std::uint64_t
+  nr_paths() const
+  {
+    return costs.size();
+  }
+};
+
+/**
+ * The header of the path table format.  The file is made of the
+ * header and the sections:
+ *
+ * - the pairs: nr_pairs structures of path_pair,
+ *
+ * - the path offsets: nr_paths + 1 numbers of uint64_t,
+ *
+ * - the path lengths: nr_paths numbers of double,
+ *
+ * - the path vertexes: nr_hops numbers of uint32_t.
+ *
+ * Like in the binary graph format, the numbers are in the byte order
+ * of the writer, and every section starts at a multiple of 8 bytes,
+ * so that a mapped file can be used in place.
+ */
+struct path_header
+{
+  // The magic number, "NGPATHS" followed by a zero.
+  char magic[8];
+  // The version of the format.
+  std::uint32_t version;
+  // The number 0x01020304 as written by the writer.
+  std::uint32_t byte_order;
+
+  std::uint64_t nr_vertices;
+  std::uint64_t nr_pairs;
+  std::uint64_t nr_paths;
+  std::uint64_t nr_hops;
+
+  // The largest number of the shortest paths of a pair.
+  std::uint32_t k;
+  std::uint32_t reserved;
+
+  // The positions of the sections in the file.
+  std::uint64_t pairs;
+  std::uint64_t offsets;
+  std::uint64_t costs;
+  std::uint64_t vertexes;
+
+  // The size of the file.
+  std::uint64_t size;
+};
+
+// The version of the path table format written.
+constexpr std::uint32_t path_version = 1;
+
+/**
+ * Write the paths of the graph with n vertexes in the path table
+ * format.
+ */
+void
+write_paths(out_buffer &out, std::uint64_t n, std::uint32_t k,
+            const path_set &s);
+
+/**
+ * The path table mapped into memory.  Nothing is copied, and the
+ * file stays mapped for as long as the table lives.
+ */
+class path_table
+{
+public:
+  /// Map the file, and check the pairs, the offsets and the vertexes
+  /// in a linear pass.  Throws std::runtime_error if the file cannot
+  /// be mapped or is not valid.
+  explicit path_table(const std::string &path);
+
+  std::uint64_t
+  nr_vertices() const
+  {
+    return m_h->nr_vertices;
+  }
+
+  std::uint32_t
+  k() const
+  {
+    return m_h->k;
+  }
+
+  std::uint64_t
+  nr_pairs() const
+  {
+    return m_h->nr_pairs;
+  }
+
+  const path_pair *
+  pairs() const
+  {
+    return m_pairs;
+  }
+
+  /// The pair of the nodes in either order, or null if not in the
+  /// table.  Takes O(log nr_pairs) time.
+  const path_pair *
+  find(std::uint32_t u, std::uint32_t v) const;
+
+  /// The first vertex of path i.
+  const std::uint32_t *
+  begin(std::uint64_t i) const
+  {
+    return m_vertexes + m_offsets[i];
+  }
+
+  /// The end of the vertexes of path i.
+  const std::uint32_t *
+  end(std::uint64_t i) const
+  {
+    return m_vertexes + m_offsets[i + 1];
+  }
+
+  /// The length of path i.
+  COST
+  cost(std::uint64_t i) const
+  {
+    return m_costs[i];
+  }
+
+private:
+  std::shared_ptr<const mapped_file> m_file;
+  const path_header *m_h;
+  const path_pair *m_pairs;
+  const std::uint64_t *m_offsets;
+  const COST *m_costs;
+  const std::uint32_t *m_vertexes;
+};
+
+#endif /* PATH_TABLE_HPP */
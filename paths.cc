@@ -0,0 +1,471 @@
+#include "paths.hpp"
+
+#include "parallel.hpp"
+#include "sampling.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+typedef csr_graph::vertex_type vertex_type;
+
+static const COST infinity = numeric_limits<COST>::infinity();
+static const vertex_type none = UINT32_MAX;
+
+namespace
+{
+  /**
+   * Dijkstra's search on the CSR graph with the weights given by a
+   * function, so that the arcs can be removed or reweighted, and
+   * optionally the A* search with a heuristic.  The vertexes are
+   * stamped with the number of the search, so that a search doesn't
+   * have to clear the arrays.
+   */
+  class search
+  {
+  public:
+    explicit search(const csr_graph &g):
+      m_g(g), m_dist(g.nr_vertices()), m_from(g.nr_vertices()),
+      m_stamp(g.nr_vertices(), 0)
+    {
+    }
+
+    /**
+     * Search from s, with weight w(v, a) of arc a leaving v, or
+     * infinity for the arc that cannot be taken.  Stop when t is
+     * reached, unless t is none.  Return true if t was reached.
+     *
+     * The vertexes are taken in the order of their distance plus
+     * h(v), the lower bound on the distance from v to t, which has to
+     * be consistent: h(v) <= w(v, a) + h(u) for arc a from v to u.
+     */
+    template <typename W, typename H>
+    bool
+    run(vertex_type s, vertex_type t, W w, H h)
+    {
+      if (++m_time == 0)
+        {
+          fill(m_stamp.begin(), m_stamp.end(), 0);
+          m_time = 1;
+        }
+
+      m_heap.clear();
+      reach(s, 0, none, h(s));
+
+      while (!m_heap.empty())
+        {
+          pop_heap(m_heap.begin(), m_heap.end(), greater<>());
+          auto [key, v] = m_heap.back();
+          m_heap.pop_back();
+
+          COST d = m_dist[v];
+          if (key > d + h(v))
+            continue;
+          if (v == t)
+            return true;
+
+          for (uint64_t a = m_g.offset(v); a < m_g.offset(v + 1); ++a)
+            {
+              COST c = w(v, a);
+              if (c == infinity)
+                continue;
+
+              vertex_type u = m_g.targets()[a];
+              if (m_stamp[u] != m_time || d + c < m_dist[u])
+                reach(u, d + c, v, d + c + h(u));
+            }
+        }
+
+      return false;
+    }
+
+    /// The distance of vertex v, or infinity if not reached.
+    COST
+    dist(vertex_type v) const
+    {
+      return m_stamp[v] == m_time ? m_dist[v] : infinity;
+    }
+
+    /// The vertexes of the path from the reached v back to the
+    /// source.
+    void
+    path_back(vertex_type v, vector<vertex_type> &p) const
+    {
+      p.clear();
+      for (; v != none; v = m_from[v])
+        p.push_back(v);
+    }
+
+    /// The vertexes of the path from the source to the reached v.
+    void
+    path(vertex_type v, vector<vertex_type> &p) const
+    {
+      path_back(v, p);
+      reverse(p.begin(), p.end());
+    }
+
+  private:
+    void
+    reach(vertex_type v, COST d, vertex_type from, COST key)
+    {
+      m_stamp[v] = m_time;
+      m_dist[v] = d;
+      m_from[v] = from;
+      m_heap.emplace_back(key, v);
+      push_heap(m_heap.begin(), m_heap.end(), greater<>());
+    }
+
+    const csr_graph &m_g;
+    vector<COST> m_dist;
+    vector<vertex_type> m_from;
+    vector<uint32_t> m_stamp;
+    uint32_t m_time = 0;
+    vector<pair<COST, vertex_type>> m_heap;
+  };
+
+  // No heuristic: Dijkstra's search.
+  COST
+  no_heuristic(vertex_type)
+  {
+    return 0;
+  }
+
+  // The path with its length.  The paths are ordered by the length,
+  // and then by the vertexes, so that the ties are broken the same
+  // way every time.
+  typedef pair<COST, vector<vertex_type>> path;
+
+  /**
+   * The paths of the pairs of one source.  A thread has one, and
+   * runs it for many sources.
+   */
+  class finder
+  {
+  public:
+    explicit finder(const csr_graph &g):
+      m_g(g), m_tree(g), m_spur(g),
+      m_banned_vertex(g.nr_vertices(), 0),
+      m_banned_arc(g.nr_arcs(), 0), m_reversed(g.nr_arcs(), 0)
+    {
+    }
+
+    /// Find the paths from source s to the destinations.
+    void
+    run(vertex_type s, const vertex_type *b, const vertex_type *e,
+        uint32_t k, path_set &r)
+    {
+      m_tree.run(s, none, [&](vertex_type, uint64_t a)
+                 {return m_g.weights()[a];}, no_heuristic);
+
+      for (; b != e; ++b)
+        {
+          path_pair p = {s, *b, 0, 0, r.nr_paths()};
+
+          if (m_tree.dist(*b) != infinity)
+            {
+              shortest(s, *b, k);
+              for (const auto &q: m_a)
+                r.add(q.second.data(), q.second.data() + q.second.size(),
+                      q.first);
+              p.shortest = m_a.size();
+
+              if (disjoint(s, *b))
+                for (const auto &q: m_pair)
+                  {
+                    r.add(q.second.data(),
+                          q.second.data() + q.second.size(), q.first);
+                    ++p.disjoint;
+                  }
+            }
+
+          r.pairs.push_back(p);
+        }
+    }
+
+  private:
+    // The arc from u to v.
+    uint64_t
+    arc(vertex_type u, vertex_type v) const
+    {
+      const uint32_t *t = m_g.targets();
+      return lower_bound(t + m_g.offset(u), t + m_g.offset(u + 1), v) - t;
+    }
+
+    // Bump the stamp of the marks.
+    void
+    next_mark()
+    {
+      if (++m_mark == 0)
+        {
+          fill(m_banned_vertex.begin(), m_banned_vertex.end(), 0);
+          fill(m_banned_arc.begin(), m_banned_arc.end(), 0);
+          fill(m_reversed.begin(), m_reversed.end(), 0);
+          m_mark = 1;
+        }
+    }
+
+    // Find the k shortest loopless paths from s to t with Yen's
+    // algorithm.  The paths are found backwards, from t to s, so that
+    // the distances of the tree of s are the heuristic of the A*
+    // search of the spur paths, which then doesn't stray far from
+    // them.
+    void
+    shortest(vertex_type s, vertex_type t, uint32_t k)
+    {
+      m_a.clear();
+      m_b.clear();
+
+      m_a.emplace_back(m_tree.dist(t), vector<vertex_type>());
+      m_tree.path_back(t, m_a.back().second);
+
+      auto h = [&](vertex_type v)
+        {
+          return m_tree.dist(v);
+        };
+
+      while (m_a.size() < k)
+        {
+          // The path the new paths deviate from, at its spur nodes.
+          const vector<vertex_type> last = m_a.back().second;
+          COST root = 0;
+
+          for (size_t i = 0; i + 1 < last.size(); ++i)
+            {
+              vertex_type spur = last[i];
+              next_mark();
+
+              // Ban the next arcs of the paths with the same root, and
+              // the vertexes of the root.
+              for (const auto &q: m_a)
+                if (q.second.size() > i + 1 &&
+                    equal(last.begin(), last.begin() + i + 1,
+                          q.second.begin()))
+                  m_banned_arc[arc(spur, q.second[i + 1])] = m_mark;
+              for (size_t j = 0; j < i; ++j)
+                m_banned_vertex[last[j]] = m_mark;
+
+              auto w = [&](vertex_type, uint64_t a)
+                {
+                  return m_banned_arc[a] == m_mark ||
+                    m_banned_vertex[m_g.targets()[a]] == m_mark ?
+                    infinity : m_g.weights()[a];
+                };
+
+              if (m_spur.run(spur, s, w, h))
+                {
+                  m_spur.path(s, m_p);
+                  path q(root + m_spur.dist(s),
+                         vector<vertex_type>(last.begin(),
+                                             last.begin() + i));
+                  q.second.insert(q.second.end(), m_p.begin(), m_p.end());
+                  m_b.insert(move(q));
+
+                  // Only the best candidates can make it.
+                  if (m_b.size() > k - m_a.size())
+                    m_b.erase(prev(m_b.end()));
+                }
+
+              root += m_g.weights()[arc(spur, last[i + 1])];
+            }
+
+          if (m_b.empty())
+            break;
+
+          m_a.push_back(move(m_b.extract(m_b.begin()).value()));
+        }
+
+      for (auto &q: m_a)
+        reverse(q.second.begin(), q.second.end());
+    }
+
+    // Find the shortest pair of the edge-disjoint paths from s to t
+    // with Suurballe's algorithm, and return true if found.  The
+    // distances from s are the potentials that make the weights
+    // nonnegative, with the arcs of the shortest path reversed.
+    bool
+    disjoint(vertex_type s, vertex_type t)
+    {
+      m_pair.clear();
+      const vector<vertex_type> &first = m_a.front().second;
+      assert(first.front() == s && first.back() == t);
+      next_mark();
+
+      for (size_t i = 0; i + 1 < first.size(); ++i)
+        {
+          m_banned_arc[arc(first[i], first[i + 1])] = m_mark;
+          m_reversed[arc(first[i + 1], first[i])] = m_mark;
+        }
+
+      auto w = [&](vertex_type v, uint64_t a)
+        {
+          if (m_banned_arc[a] == m_mark)
+            return infinity;
+          if (m_reversed[a] == m_mark)
+            return COST(0);
+          COST c = m_g.weights()[a] + m_tree.dist(v) -
+            m_tree.dist(m_g.targets()[a]);
+          return max(c, COST(0));
+        };
+
+      // The path from v to t is at least d(v) - d(t) long, and its
+      // length with the potentials is at least twice that.  On the
+      // reversed arcs the heuristic is 0, since d(v) <= d(t) there.
+      COST dt = m_tree.dist(t);
+      auto h = [&](vertex_type v)
+        {
+          return 2 * max(m_tree.dist(v) - dt, COST(0));
+        };
+
+      if (!m_spur.run(s, t, w, h))
+        return false;
+      m_spur.path(t, m_p);
+
+      // The arcs of both paths, without the arcs of the first path
+      // that the second one takes back, which stop being banned.
+      m_arcs.clear();
+      for (size_t i = 0; i + 1 < m_p.size(); ++i)
+        if (m_reversed[arc(m_p[i], m_p[i + 1])] == m_mark)
+          m_banned_arc[arc(m_p[i + 1], m_p[i])] = 0;
+        else
+          m_arcs.emplace_back(m_p[i], m_p[i + 1]);
+      for (size_t i = 0; i + 1 < first.size(); ++i)
+        if (m_banned_arc[arc(first[i], first[i + 1])] == m_mark)
+          m_arcs.emplace_back(first[i], first[i + 1]);
+      sort(m_arcs.begin(), m_arcs.end());
+
+      // Follow the arcs from s to t twice.
+      vector<bool> used(m_arcs.size(), false);
+      for (int j = 0; j < 2; ++j)
+        {
+          path q(0, {s});
+          for (vertex_type v = s; v != t; )
+            {
+              auto i = lower_bound(m_arcs.begin(), m_arcs.end(),
+                                   make_pair(v, vertex_type(0)));
+              while (used[i - m_arcs.begin()])
+                ++i;
+              used[i - m_arcs.begin()] = true;
+              q.first += m_g.weights()[arc(v, i->second)];
+              v = i->second;
+              q.second.push_back(v);
+            }
+          m_pair.push_back(move(q));
+        }
+
+      sort(m_pair.begin(), m_pair.end());
+
+      return true;
+    }
+
+    const csr_graph &m_g;
+
+    // The tree of the source, and the search of the spur paths.
+    search m_tree;
+    search m_spur;
+
+    // The marks of the banned and the reversed arcs, and of the
+    // banned vertexes: the arc or the vertex is marked if its stamp
+    // equals m_mark.
+    vector<uint32_t> m_banned_vertex;
+    vector<uint32_t> m_banned_arc;
+    vector<uint32_t> m_reversed;
+    uint32_t m_mark = 0;
+
+    // The shortest paths found, and the candidates of Yen's
+    // algorithm.
+    vector<path> m_a;
+    set<path> m_b;
+
+    // The disjoint pair.
+    vector<path> m_pair;
+
+    // The scratch path, and the arcs of the disjoint pair.
+    vector<vertex_type> m_p;
+    vector<pair<vertex_type, vertex_type>> m_arcs;
+  };
+}
+
+path_set
+find_paths(const csr_graph &g, uint32_t k, uint64_t pairs, unsigned threads,
+           const philox &eng)
+{
+  vertex_type n = g.nr_vertices();
+  uint64_t all = uint64_t(n) * (n - 1) / 2;
+
+  // The destinations of the sampled pairs, with the offsets of the
+  // sources.  Without the sample, the destinations of source s are
+  // all the nodes after s.
+  bool sampled = pairs && pairs < all;
+  vector<uint64_t> offsets;
+  vector<vertex_type> dsts;
+
+  if (sampled)
+    {
+      philox e = eng.split(paths_stream);
+      offsets.assign(n + 1, 0);
+      dsts.reserve(pairs);
+
+      // Pair r is in row u of the upper triangle.
+      uint64_t u = 0, row_end = n - 1;
+      sample_sorted(pairs, all, e, [&](uint64_t r)
+        {
+          while (r >= row_end)
+            row_end += n - 1 - ++u;
+          dsts.push_back(r - (row_end - (n - 1 - u)) + u + 1);
+          ++offsets[u + 1];
+        });
+
+      for (vertex_type v = 0; v < n; ++v)
+        offsets[v + 1] += offsets[v];
+    }
+  else
+    {
+      dsts.resize(n);
+      for (vertex_type v = 0; v < n; ++v)
+        dsts[v] = v;
+    }
+
+  // The paths of every source, merged in the order of the sources.
+  vector<path_set> results(n);
+  threads = min<size_t>(nr_threads(threads), max<size_t>(n, 1));
+  vector<unique_ptr<finder>> finders(threads);
+
+  parallel_for(n, threads, [&](size_t s, unsigned t)
+    {
+      const vertex_type *d = dsts.data();
+      const vertex_type *b = d + (sampled ? offsets[s] : s + 1);
+      const vertex_type *e = d + (sampled ? offsets[s + 1] : n);
+      if (b == e)
+        return;
+
+      if (!finders[t])
+        finders[t].reset(new finder(g));
+      finders[t]->run(s, b, e, k, results[s]);
+    });
+
+  path_set r;
+  for (auto &p: results)
+    {
+      uint64_t first = r.nr_paths();
+      for (auto q: p.pairs)
+        {
+          q.first += first;
+          r.pairs.push_back(q);
+        }
+
+      for (size_t i = 0; i < p.nr_paths(); ++i)
+        r.add(&p.vertexes[p.offsets[i]], &p.vertexes[p.offsets[i + 1]],
+              p.costs[i]);
+
+      p = path_set();
+    }
+
+  return r;
+}
@@ -0,0 +1,37 @@
+#ifndef PATHS_HPP
+#define PATHS_HPP
+
+#include "csr_graph.hpp"
+#include "path_table.hpp"
+#include "philox.hpp"
+
+#include <cstdint>
+
+// The stream of the sampled node pairs, after those of the analyses.
+enum paths_stream_t {paths_stream = (1 << 16) + 3};
+
+/**
+ * Find the paths of the path table for the node pairs: the k
+ * shortest loopless paths with Yen's algorithm, and the shortest
+ * pair of the edge-disjoint paths with Suurballe's algorithm.
+ *
+ * The pairs are grouped by the smaller node, which is the source of
+ * their paths.  The sources are run in parallel on the given number
+ * of threads.  For every source, the tree of the shortest paths is
+ * found once: it gives the first of the k shortest paths to every
+ * node, and the potentials of Suurballe's algorithm.  Then Yen's
+ * algorithm finds the paths backwards, from the destination to the
+ * source: it runs the A* search from every node of the last path
+ * found (the spur node) back to the source, with the distances of
+ * the tree as the heuristic, and stops as soon as the source is
+ * reached.
+ *
+ * If pairs is not zero and smaller than the number of the node
+ * pairs, that many pairs are drawn at random, otherwise all the pairs
+ * are taken.  The result doesn't depend on the number of threads.
+ */
+path_set
+find_paths(const csr_graph &g, std::uint32_t k, std::uint64_t pairs,
+           unsigned threads, const philox &eng);
+
+#endif /* PATHS_HPP */
@@ -0,0 +1,145 @@
+#include "percolation.hpp"
+
+#include "union_find.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+
+using namespace std;
+
+typedef csr_graph::vertex_type vertex_type;
+
+namespace
+{
+  /**
+   * The records of the curve, as the items are added back.  After
+   * the items are added, the largest component is recorded for the
+   * points with that many items removed.
+   */
+  class curve
+  {
+    percolation_result &m_r;
+    uint64_t m_items;
+    double m_n;
+    int m_points;
+    int m_k;
+
+    // The number of the items removed at point k.
+    uint64_t
+    removed(int k) const
+    {
+      return m_items * k / m_points;
+    }
+
+  public:
+    curve(percolation_result &r, uint64_t items, vertex_type n, int points):
+      m_r(r), m_items(items), m_n(n), m_points(points), m_k(points)
+    {
+      m_r.giant.assign(points + 1, 0);
+      m_r.robustness = 0;
+    }
+
+    /// Record the largest component with the given number added.
+    void
+    operator()(uint64_t added, vertex_type largest)
+    {
+      uint64_t r = m_items - added;
+
+      for (; m_k >= 0 && removed(m_k) == r; --m_k)
+        m_r.giant[m_k] = largest / m_n;
+
+      if (r)
+        m_r.robustness += largest / m_n / m_items;
+    }
+  };
+}
+
+percolation_result
+percolation(const csr_graph &g, attack_t attack, int points,
+            const philox &eng)
+{
+  assert(points >= 1);
+
+  vertex_type n = g.nr_vertices();
+  philox e = eng.split(percolation_stream);
+  percolation_result result;
+
+  // With no vertexes, there is no component, not even the largest.
+  if (!n)
+    {
+      result.giant.assign(points + 1, 0);
+      result.robustness = 0;
+      return result;
+    }
+
+  union_find uf(n);
+
+  if (attack == attack_t::random_nodes || attack == attack_t::degree_nodes)
+    {
+      // The nodes in the order of removal.
+      vector<vertex_type> order(n);
+      iota(order.begin(), order.end(), 0);
+      shuffle(order.begin(), order.end(), e);
+      if (attack == attack_t::degree_nodes)
+        stable_sort(order.begin(), order.end(),
+                    [&g](vertex_type a, vertex_type b)
+                    {return g.degree(a) > g.degree(b);});
+
+      curve c(result, n, n, points);
+      vector<char> present(n, false);
+      vertex_type largest = 0;
+
+      c(0, largest);
+      for (uint64_t i = 0; i < n; ++i)
+        {
+          vertex_type v = order[n - 1 - i];
+          present[v] = true;
+
+          for (auto a = g.offset(v); a < g.offset(v + 1); ++a)
+            if (present[g.targets()[a]])
+              uf.unite(v, g.targets()[a]);
+
+          largest = max(largest, uf.size(v));
+          c(i + 1, largest);
+        }
+    }
+  else
+    {
+      // The links in the order of removal.
+      vector<pair<vertex_type, vertex_type>> order;
+      order.reserve(g.nr_edges());
+      for (vertex_type v = 0; v < n; ++v)
+        for (auto a = g.offset(v); a < g.offset(v + 1); ++a)
+          if (g.targets()[a] > v)
+            order.emplace_back(v, g.targets()[a]);
+      shuffle(order.begin(), order.end(), e);
+
+      if (attack == attack_t::degree_links)
+        {
+          auto product = [&g](const pair<vertex_type, vertex_type> &l)
+            {
+              return uint64_t(g.degree(l.first)) * g.degree(l.second);
+            };
+          stable_sort(order.begin(), order.end(),
+                      [&](const pair<vertex_type, vertex_type> &a,
+                          const pair<vertex_type, vertex_type> &b)
+                      {return product(a) > product(b);});
+        }
+
+      uint64_t m = order.size();
+      curve c(result, m, n, points);
+
+      c(0, uf.largest());
+      for (uint64_t i = 0; i < m; ++i)
+        {
+          const auto &l = order[m - 1 - i];
+          uf.unite(l.first, l.second);
+          c(i + 1, uf.largest());
+        }
+    }
+
+  return result;
+}
@@ -0,0 +1,52 @@
+#ifndef PERCOLATION_HPP
+#define PERCOLATION_HPP
+
+#include "cli_args.hpp"
+#include "csr_graph.hpp"
+#include "philox.hpp"
+
+#include <vector>
+
+// The stream of the removal order, apart from those of the generators.
+enum percolation_stream_t {percolation_stream = 1 << 16};
+
+/**
+ * The result of the percolation of a graph.
+ */
+struct percolation_result
+{
+  /// The size of the largest component, as a fraction of all the
+  /// vertexes, after the fraction k / points of the nodes or links
+  /// was removed, for k = 0, ..., points.
+  std::vector<double> giant;
+
+  /// The robustness: the mean size of the largest component, as a
+  /// fraction of all the vertexes, over all the numbers of the nodes
+  /// or links removed, from one to all.
+  double robustness;
+};
+
+/**
+ * Remove the nodes or the links of the graph one by one in the order
+ * of the attack, and find the size of the largest component after
+ * every removal.  The attacks remove:
+ *
+ * - random_nodes: the nodes in a random order,
+ *
+ * - degree_nodes: the nodes by decreasing degree in the graph,
+ *
+ * - random_links: the links in a random order,
+ *
+ * - degree_links: the links by decreasing product of the degrees of
+ *   their end nodes.
+ *
+ * The ties are broken at random.  Like in the algorithm of Newman and
+ * Ziff, the nodes or the links are not removed but added back in the
+ * reverse order, and the components are tracked with the union-find,
+ * so that the whole curve takes near-linear time.
+ */
+percolation_result
+percolation(const csr_graph &g, attack_t attack, int points,
+            const philox &eng);
+
+#endif /* PERCOLATION_HPP */
@@ -0,0 +1,127 @@
+#ifndef PHILOX_HPP
+#define PHILOX_HPP
+
+#include <array>
+#include <cstdint>
+
+/**
+ * The Philox4x32-10 counter-based random number generator of Salmon
+ * et al. (Random123).  A block of four 32-bit numbers is a function
+ * of the key and the 128-bit counter only, so any block can be
+ * computed directly, without generating the preceding ones.
+ *
+ * The key is made of the seed and the replica number.  The upper 64
+ * bits of the counter select a stream, and the lower 64 bits are the
+ * block number in the stream.  The streams of a generator are
+ * independent, so a graph generator can give each of its parts (the
+ * topology, the weights, a range of vertexes) a stream of its own,
+ * and then it does not matter in which order, or in which thread,
+ * the parts are generated.
+ *
+ * The class satisfies the UniformRandomBitGenerator requirements, so
+ * it can also be used sequentially with the standard distributions.
+ */
+class philox
+{
+public:
+  typedef std::uint32_t result_type;
+  typedef std::array<std::uint32_t, 4> block_type;
+
+  explicit philox(std::uint32_t seed = 0, std::uint32_t replica = 0,
+                  std::uint64_t stream = 0):
+    m_key{seed, replica}, m_stream(stream)
+  {
+  }
+
+  /**
+   * Return the generator of the given stream.  The purpose tells
+   * apart the parts of a generator, and the index numbers the streams
+   * of the same purpose, e.g., the vertex ranges.
+   */
+  philox
+  split(std::uint32_t purpose, std::uint32_t index = 0) const
+  {
+    return philox(m_key[0], m_key[1],
+                  std::uint64_t(purpose) << 32 | index);
+  }
+
+  /// Return the block of the given number in this stream.
+  block_type
+  block(std::uint64_t number) const
+  {
+    block_type c = {std::uint32_t(number), std::uint32_t(number >> 32),
+                    std::uint32_t(m_stream),
+                    std::uint32_t(m_stream >> 32)};
+    std::array<std::uint32_t, 2> k = m_key;
+
+    for (int r = 0; r < 10; ++r)
+      {
+        if (r)
+          {
+            k[0] += 0x9E3779B9;
+            k[1] += 0xBB67AE85;
+          }
+
+        std::uint64_t p0 = std::uint64_t(0xD2511F53) * c[0];
+        std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * c[2];
+        c = {std::uint32_t(p1 >> 32) ^ c[1] ^ k[0], std::uint32_t(p1),
+             std::uint32_t(p0 >> 32) ^ c[3] ^ k[1], std::uint32_t(p0)};
+      }
+
+    return c;
+  }
+
+  /// Position the generator at the beginning of the given block.
+  void
+  seek(std::uint64_t number)
+  {
+    m_next = number;
+    m_used = 4;
+  }
+
+  result_type
+  operator()()
+  {
+    if (m_used == 4)
+      {
+        m_buffer = block(m_next++);
+        m_used = 0;
+      }
+
+    return m_buffer[m_used++];
+  }
+
+  static constexpr result_type
+  min()
+  {
+    return 0;
+  }
+
+  static constexpr result_type
+  max()
+  {
+    return UINT32_MAX;
+  }
+
+private:
+  std::array<std::uint32_t, 2> m_key;
+  std::uint64_t m_stream;
+
+  // The number of the next block to generate.
+  std::uint64_t m_next = 0;
+  // The current block, and the number of its values already used.
+  block_type m_buffer;
+  int m_used = 4;
+};
+
+/**
+ * Map a random 32-bit value to an integer from 0 to n - 1, with
+ * Lemire's multiply-and-shift method.  The bias is at most n / 2^32.
+ */
+inline std::uint32_t
+scale_to(std::uint32_t x, std::uint32_t n)
+{
+  return std::uint64_t(x) * n >> 32;
+}
+
+#endif /* PHILOX_HPP */
@@ -0,0 +1,181 @@
+#include "print_stats.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+using namespace std;
+
+// Print the JSON string.
+static void
+json_string(ostream &os, const string &s)
+{
+  os << '"';
+  for (unsigned char c: s)
+    if (c == '"' || c == '\\')
+      os << '\\' << c;
+    else if (c < 0x20)
+      {
+        char b[8];
+        snprintf(b, sizeof(b), "\\u%04x", c);
+        os << b;
+      }
+    else
+      os << c;
+  os << '"';
+}
+
+// Print the JSON number, which is the shortest that reads back the
+// same, or null if it's not finite.
+static void
+json_number(ostream &os, double x)
+{
+  if (!isfinite(x))
+    {
+      os << "null";
+      return;
+    }
+
+  char b[32];
+  os.write(b, to_chars(b, b + sizeof(b), x).ptr - b);
+}
+
+stats_printer::stats_printer(ostream &os, stats_format_t format):
+  m_os(os), m_format(format), m_first_stat(true), m_first_value(true)
+{
+}
+
+void
+stats_printer::begin()
+{
+  m_first_stat = true;
+  if (m_format == stats_format_t::json)
+    m_os << '{';
+}
+
+void
+stats_printer::end()
+{
+  if (m_format == stats_format_t::json)
+    m_os << '}' << endl;
+}
+
+void
+stats_printer::start(const string &name)
+{
+  m_first_value = true;
+
+  if (m_format == stats_format_t::text)
+    m_os << name << ": ";
+  else
+    {
+      if (!m_first_stat)
+        m_os << ", ";
+      json_string(m_os, name);
+      m_os << ": {";
+    }
+
+  m_first_stat = false;
+}
+
+ostream &
+stats_printer::member(const string &name)
+{
+  if (!m_first_value)
+    m_os << ", ";
+  m_first_value = false;
+
+  if (m_format == stats_format_t::text)
+    m_os << name << " = ";
+  else
+    {
+      json_string(m_os, name);
+      m_os << ": ";
+    }
+
+  return m_os;
+}
+
+void
+stats_printer::value(const string &name, double x)
+{
+  ostream &os = member(name);
+  if (m_format == stats_format_t::text)
+    os << x;
+  else
+    json_number(os, x);
+}
+
+void
+stats_printer::finish()
+{
+  if (m_format == stats_format_t::text)
+    m_os << endl;
+  else
+    m_os << '}';
+}
+
+// Print the values of dbl_acc, without finishing the statistic.
+template <typename T>
+static void
+print_moments(stats_printer &p, const string &name, const T &a)
+{
+  p.start(name);
+  if (p.format() == stats_format_t::json)
+    p.value("count", a.count());
+  p.value("min", a.min());
+  p.value("mean", a.mean());
+  p.value("max", a.max());
+  p.value("variance", a.variance());
+}
+
+// Print the percentiles, without finishing the statistic.
+template <typename T>
+static void
+print_quantiles(stats_printer &p, const T &a)
+{
+  p.value("p50", a.quantile(0.5));
+  p.value("p95", a.quantile(0.95));
+  p.value("p99", a.quantile(0.99));
+}
+
+void
+print_stats(stats_printer &p, const string &name, const dbl_acc &a)
+{
+  print_moments(p, name, a);
+  p.finish();
+}
+
+void
+print_stats(stats_printer &p, const string &name, const quantile_acc &a)
+{
+  print_moments(p, name, a);
+  print_quantiles(p, a);
+  p.finish();
+}
+
+void
+print_stats(stats_printer &p, const string &name, const histogram_acc &a)
+{
+  print_moments(p, name, a);
+  print_quantiles(p, a);
+
+  const auto &b = a.buckets();
+  if (p.format() == stats_format_t::text)
+    {
+      p.finish();
+      p.start(name + " histogram");
+      for (size_t i = 0; i < b.size(); ++i)
+        if (b[i])
+          p.member(to_string(i * a.width())) << b[i];
+    }
+  else
+    {
+      ostream &os = p.member("histogram");
+      os << "{\"width\": " << a.width() << ", \"buckets\": [";
+      for (size_t i = 0; i < b.size(); ++i)
+        os << (i ? ", " : "") << b[i];
+      os << "]}";
+    }
+  p.finish();
+}
@@ -0,0 +1,90 @@
+#ifndef PRINT_STATS_HPP
+#define PRINT_STATS_HPP
+
+#include "cli_args.hpp"
+#include "dbl_acc.hpp"
+#include "histogram_acc.hpp"
+#include "quantile_acc.hpp"
+
+#include <ostream>
+#include <string>
+
+/**
+ * The printer of the statistics.  In the text format, a statistic is
+ * printed as a line with its name and its values.  In the JSON
+ * format, the statistics of a record, from begin() to end(), make a
+ * single object on a line, with a member per statistic, so that the
+ * records can be read as JSON lines.  The numbers that are not
+ * finite are null.
+ */
+class stats_printer
+{
+public:
+  stats_printer(std::ostream &os, stats_format_t format);
+
+  stats_format_t
+  format() const
+  {
+    return m_format;
+  }
+
+  /// Start the record.
+  void
+  begin();
+
+  /// End the record.
+  void
+  end();
+
+  /// Start the statistic with the name.
+  void
+  start(const std::string &name);
+
+  /// Start the value of the statistic with the name, and return the
+  /// stream to print it to: "name = " in the text format, and the
+  /// member in the JSON format.
+  std::ostream &
+  member(const std::string &name);
+
+  /// Print the number as the value of the statistic.
+  void
+  value(const std::string &name, double x);
+
+  /// End the statistic.
+  void
+  finish();
+
+private:
+  std::ostream &m_os;
+  stats_format_t m_format;
+
+  // The statistic or its value is the first one.
+  bool m_first_stat;
+  bool m_first_value;
+};
+
+/**
+ * Print the count, the min, the mean, the max and the variance.
+ */
+void
+print_stats(stats_printer &p, const std::string &name, const dbl_acc &a);
+
+/**
+ * Print the statistics of dbl_acc, and the median, the 95th and the
+ * 99th percentile.
+ */
+void
+print_stats(stats_printer &p, const std::string &name,
+            const quantile_acc &a);
+
+/**
+ * Print the statistics of quantile_acc, and the histogram: in the
+ * text format a line with the start and the count of the buckets
+ * used, and in the JSON format the width and the counts of all the
+ * buckets.
+ */
+void
+print_stats(stats_printer &p, const std::string &name,
+            const histogram_acc &a);
+
+#endif /* PRINT_STATS_HPP */
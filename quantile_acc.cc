@@ -0,0 +1,118 @@
+#include "quantile_acc.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+constexpr double quantile_acc::default_compression;
+
+quantile_acc::quantile_acc(double compression):
+  m_compression(compression),
+  m_buffer_size(ceil(10 * compression))
+{
+  m_buffer.reserve(m_buffer_size);
+}
+
+void
+quantile_acc::merge(const quantile_acc &a)
+{
+  m_moments.merge(a.m_moments);
+
+  for (const auto *v: {&a.m_centroids, &a.m_buffer})
+    for (const auto &c: *v)
+      {
+        m_buffer.push_back(c);
+        if (m_buffer.size() >= m_buffer_size)
+          compress();
+      }
+}
+
+void
+quantile_acc::compress()
+{
+  if (m_buffer.empty())
+    return;
+
+  // The centroids and the buffer, sorted by the mean.  Of the equal
+  // means, the centroids go first, in the order they were added.
+  m_buffer.insert(m_buffer.begin(), m_centroids.begin(),
+                  m_centroids.end());
+  stable_sort(m_buffer.begin(), m_buffer.end(),
+              [](const auto &a, const auto &b) {return a.first < b.first;});
+
+  double total = 0;
+  for (const auto &c: m_buffer)
+    total += c.second;
+
+  auto k = [&](double q)
+    {
+      return m_compression / (2 * M_PI) * asin(2 * q - 1);
+    };
+
+  // The weight before the current centroid, and its scale.
+  double before = 0;
+  double k_before = k(0);
+
+  m_centroids.clear();
+  auto cur = m_buffer.front();
+  for (auto i = m_buffer.begin() + 1; i != m_buffer.end(); ++i)
+    {
+      double q = std::min(1.0, (before + cur.second + i->second) / total);
+      if (k(q) - k_before <= 1)
+        {
+          cur.second += i->second;
+          cur.first += (i->first - cur.first) * i->second / cur.second;
+        }
+      else
+        {
+          m_centroids.push_back(cur);
+          before += cur.second;
+          k_before = k(before / total);
+          cur = *i;
+        }
+    }
+  m_centroids.push_back(cur);
+
+  m_buffer.clear();
+}
+
+double
+quantile_acc::quantile(double q) const
+{
+  if (!count())
+    return numeric_limits<double>::quiet_NaN();
+
+  if (!m_buffer.empty())
+    {
+      quantile_acc a = *this;
+      a.compress();
+      return a.quantile(q);
+    }
+
+  // The sample of rank q * count, where the samples of a centroid are
+  // spread around its mean, and the ends are the min and the max.
+  double rank = clamp(q, 0.0, 1.0) * count();
+  const auto &c = m_centroids;
+
+  double before = 0;
+  double prev_mean = min();
+  double prev_rank = 0;
+  for (size_t i = 0; i < c.size(); ++i)
+    {
+      double center = before + c[i].second / 2;
+      if (rank < center)
+        {
+          double f = (rank - prev_rank) / (center - prev_rank);
+          return prev_mean + f * (c[i].first - prev_mean);
+        }
+      prev_mean = c[i].first;
+      prev_rank = center;
+      before += c[i].second;
+    }
+
+  double f = before > prev_rank ? (rank - prev_rank) / (before - prev_rank)
+    : 1;
+  return prev_mean + f * (max() - prev_mean);
+}
@@ -0,0 +1,98 @@
+#ifndef QUANTILE_ACC_HPP
+#define QUANTILE_ACC_HPP
+
+#include "dbl_acc.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * The accumulator that estimates the quantiles of the samples in
+ * constant memory, with the merging t-digest of Dunning and Ertl.
+ * The samples are buffered, and the buffer is merged into the
+ * centroids, each with the mean and the number of its samples.  A
+ * centroid may only grow as long as it spans a unit of the scale
+ * function k(q) = compression / (2 pi) asin(2q - 1), so the centroids
+ * are the smallest in the tails, and the extreme quantiles are the
+ * most accurate.  The count, the min, the max, the mean and the
+ * variance are exact, kept by dbl_acc.
+ *
+ * Two accumulators are merged by merging the centroids of one into
+ * the other.  Like with dbl_acc, merging the accumulators in the same
+ * order gives the same result, no matter which thread filled which.
+ */
+class quantile_acc
+{
+public:
+  // The default compression, which keeps about as many centroids at
+  // most.
+  static constexpr double default_compression = 100;
+
+  explicit quantile_acc(double compression = default_compression);
+
+  /// Add a sample.
+  void
+  operator()(double x)
+  {
+    m_moments(x);
+    m_buffer.emplace_back(x, 1);
+    if (m_buffer.size() >= m_buffer_size)
+      compress();
+  }
+
+  /// Merge the samples of the other accumulator into this one.
+  void
+  merge(const quantile_acc &a);
+
+  /// The estimate of quantile q, from 0 to 1, or NaN if there are no
+  /// samples.
+  double
+  quantile(double q) const;
+
+  std::size_t
+  count() const
+  {
+    return m_moments.count();
+  }
+
+  double
+  min() const
+  {
+    return m_moments.min();
+  }
+
+  double
+  max() const
+  {
+    return m_moments.max();
+  }
+
+  double
+  mean() const
+  {
+    return m_moments.mean();
+  }
+
+  double
+  variance() const
+  {
+    return m_moments.variance();
+  }
+
+private:
+  // Merge the buffer into the centroids.
+  void
+  compress();
+
+  double m_compression;
+  std::size_t m_buffer_size;
+  dbl_acc m_moments;
+
+  // The centroids, sorted by the mean, and the buffer, as the pairs
+  // of the mean and the weight.
+  std::vector<std::pair<double, double>> m_centroids;
+  std::vector<std::pair<double, double>> m_buffer;
+};
+
+#endif /* QUANTILE_ACC_HPP */
@@ -0,0 +1,346 @@
+#include "query.hpp"
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+typedef csr_graph::vertex_type vertex_type;
+
+static const COST infinity = numeric_limits<COST>::infinity();
+
+// The number of the queries in a batch.
+static const size_t batch_size = 1 << 16;
+
+double
+euclid_factor(const csr_graph &g)
+{
+  const location *l = g.locations();
+  if (!l)
+    return 0;
+
+  double factor = infinity;
+  for (vertex_type v = 0; v < g.nr_vertices(); ++v)
+    for (auto a = g.offset(v); a < g.offset(v + 1); ++a)
+      {
+        const location &w = l[g.targets()[a]];
+        double d = hypot(l[v].x - w.x, l[v].y - w.y);
+        if (d > 0)
+          factor = min(factor, g.weights()[a] / d);
+      }
+
+  return factor == infinity ? 0 : factor;
+}
+
+point_search::point_search(const csr_graph &g, double factor):
+  m_g(g), m_factor(factor), m_dist(g.nr_vertices()),
+  m_hops(g.nr_vertices()), m_stamp(g.nr_vertices(), 0)
+{
+}
+
+COST
+point_search::bound(vertex_type v) const
+{
+  if (!m_factor)
+    return 0;
+
+  const location &l = m_g.locations()[v];
+  return m_factor * hypot(l.x - m_target.x, l.y - m_target.y);
+}
+
+COST
+point_search::run(vertex_type s, vertex_type t)
+{
+  if (++m_time == 0)
+    {
+      fill(m_stamp.begin(), m_stamp.end(), 0);
+      m_time = 1;
+    }
+
+  if (m_factor)
+    m_target = m_g.locations()[t];
+
+  greater<pair<COST, vertex_type>> cmp;
+  m_heap.clear();
+  m_settled = 0;
+
+  m_stamp[s] = m_time;
+  m_dist[s] = 0;
+  m_hops[s] = 0;
+  m_heap.emplace_back(bound(s), s);
+
+  while (!m_heap.empty())
+    {
+      pop_heap(m_heap.begin(), m_heap.end(), cmp);
+      auto [key, u] = m_heap.back();
+      m_heap.pop_back();
+
+      // The stale entry of the vertex reached again.
+      COST d = m_dist[u];
+      if (key > d + bound(u))
+        continue;
+
+      ++m_settled;
+      if (u == t)
+        {
+          m_path_hops = m_hops[u];
+          return d;
+        }
+
+      for (auto a = m_g.offset(u); a < m_g.offset(u + 1); ++a)
+        {
+          vertex_type v = m_g.targets()[a];
+          COST nd = d + m_g.weights()[a];
+
+          if (m_stamp[v] != m_time || nd < m_dist[v])
+            {
+              m_stamp[v] = m_time;
+              m_dist[v] = nd;
+              m_hops[v] = m_hops[u] + 1;
+              m_heap.emplace_back(nd + bound(v), v);
+              push_heap(m_heap.begin(), m_heap.end(), cmp);
+            }
+        }
+    }
+
+  return infinity;
+}
+
+void
+latency_histogram::operator()(double us)
+{
+  size_t i = 0;
+  for (double b = 1; us >= b && i < 63; b *= 2)
+    ++i;
+
+  if (buckets.size() <= i)
+    buckets.resize(i + 1, 0);
+  ++buckets[i];
+}
+
+void
+latency_histogram::merge(const latency_histogram &h)
+{
+  if (buckets.size() < h.buckets.size())
+    buckets.resize(h.buckets.size(), 0);
+  for (size_t i = 0; i < h.buckets.size(); ++i)
+    buckets[i] += h.buckets[i];
+}
+
+namespace
+{
+  // The query with the ends of its source and destination in the
+  // line, which are copied to the answer.
+  struct query
+  {
+    string line;
+    size_t src_begin;
+    size_t src_end;
+    size_t dst_begin;
+    size_t dst_end;
+    vertex_type src;
+    vertex_type dst;
+  };
+
+  // The answer to the query.
+  struct answer
+  {
+    COST length;
+    uint32_t hops;
+  };
+
+  // Parse the vertex: the bare number, or "v" followed by the number
+  // from 1.
+  vertex_type
+  parse_vertex(string_view s, vertex_type n, uint64_t line)
+  {
+    bool v = !s.empty() && s[0] == 'v';
+    if (v)
+      s.remove_prefix(1);
+
+    uint64_t x;
+    auto r = from_chars(s.data(), s.data() + s.size(), x);
+    if (s.empty() || r.ec != errc() || r.ptr != s.data() + s.size() ||
+        (v && x == 0) || x - v >= n)
+      throw runtime_error("Bad vertex in query line "
+                          + to_string(line) + ".");
+
+    return x - v;
+  }
+
+  // Read the next token of the line from position p.
+  string_view
+  token(const string &line, size_t &p)
+  {
+    while (p < line.size() && isspace(static_cast<unsigned char>(line[p])))
+      ++p;
+    size_t b = p;
+    while (p < line.size() && !isspace(static_cast<unsigned char>(line[p])))
+      ++p;
+    return string_view(line).substr(b, p - b);
+  }
+
+  /**
+   * Read the next batch of the queries, and return false if there
+   * are no more.  The batch ends early when the input has nothing
+   * more ready, so that the queries coming slowly, e.g., from a pipe,
+   * are answered as they come, not when the batch is full.
+   */
+  bool
+  read_batch(istream &in, vertex_type n, vector<query> &batch,
+             uint64_t &line)
+  {
+    batch.clear();
+    string s;
+
+    while (batch.size() < batch_size && getline(in, s))
+      {
+        ++line;
+        size_t p = 0;
+        string_view src = token(s, p);
+        if (src.empty() || src[0] == '#')
+          continue;
+
+        size_t src_end = p;
+        string_view dst = token(s, p);
+        if (dst.empty())
+          throw runtime_error("No destination in query line "
+                              + to_string(line) + ".");
+
+        query q;
+        q.src = parse_vertex(src, n, line);
+        q.dst = parse_vertex(dst, n, line);
+        q.src_begin = src.data() - s.data();
+        q.src_end = src_end;
+        q.dst_begin = dst.data() - s.data();
+        q.dst_end = p;
+        q.line = move(s);
+        batch.push_back(move(q));
+
+        if (in.rdbuf()->in_avail() <= 0)
+          break;
+      }
+
+    if (in.bad())
+      throw runtime_error("Cannot read the queries.");
+
+    return !batch.empty();
+  }
+}
+
+query_summary
+answer_queries(const csr_graph &g, const ch_table *ch, istream &in,
+               out_buffer &out, unsigned threads)
+{
+  typedef chrono::steady_clock clock;
+
+  vertex_type n = g.nr_vertices();
+  double factor = ch ? 0 : euclid_factor(g);
+
+  // The state and the summary of the threads.  The summaries are
+  // merged in the order of the threads.
+  struct state
+  {
+    unique_ptr<point_search> search;
+    unique_ptr<ch_query> ch_search;
+    vector<vertex_type> path;
+    query_summary summary;
+  };
+
+  threads = nr_threads(threads);
+  vector<state> states(threads);
+
+  vector<query> batch;
+  vector<answer> answers;
+  uint64_t line = 0;
+
+  while (read_batch(in, n, batch, line))
+    {
+      answers.resize(batch.size());
+
+      parallel_for(batch.size(), threads, [&](size_t i, unsigned t)
+        {
+          state &s = states[t];
+          auto start = clock::now();
+          COST length;
+          uint32_t hops, settled;
+
+          if (ch)
+            {
+              if (!s.ch_search)
+                s.ch_search.reset(new ch_query(*ch));
+              length = s.ch_search->distance(batch[i].src, batch[i].dst);
+              s.ch_search->path(s.path);
+              hops = s.path.empty() ? 0 : s.path.size() - 1;
+              settled = s.ch_search->settled();
+            }
+          else
+            {
+              if (!s.search)
+                s.search.reset(new point_search(g, factor));
+              length = s.search->run(batch[i].src, batch[i].dst);
+              hops = s.search->hops();
+              settled = s.search->settled();
+            }
+
+          chrono::duration<double, micro> us = clock::now() - start;
+
+          answers[i] = {length, hops};
+          s.summary.latency(us.count());
+          s.summary.histogram(us.count());
+          s.summary.settled(settled);
+          s.summary.unreachable += length == infinity;
+        });
+
+      for (size_t i = 0; i < batch.size(); ++i)
+        {
+          const query &q = batch[i];
+          const answer &a = answers[i];
+
+          char *p = out.reserve(q.dst_end + 64);
+          p = copy(q.line.data() + q.src_begin, q.line.data() + q.src_end,
+                   p);
+          *p++ = ' ';
+          p = copy(q.line.data() + q.dst_begin, q.line.data() + q.dst_end,
+                   p);
+          *p++ = ' ';
+          if (a.length == infinity)
+            {
+              static const char none[] = "inf inf";
+              p = copy(none, none + sizeof(none) - 1, p);
+            }
+          else
+            {
+              p = to_chars(p, p + 32, a.length).ptr;
+              *p++ = ' ';
+              p = to_chars(p, p + 16, a.hops).ptr;
+            }
+          *p++ = '\n';
+          out.commit(p);
+        }
+
+      // The answers of the batch go out before waiting for the next.
+      out.flush();
+    }
+
+  query_summary r;
+  for (auto &s: states)
+    {
+      r.latency.merge(s.summary.latency);
+      r.histogram.merge(s.summary.histogram);
+      r.settled.merge(s.summary.settled);
+      r.unreachable += s.summary.unreachable;
+    }
+
+  return r;
+}
@@ -0,0 +1,132 @@
+#ifndef QUERY_HPP
+#define QUERY_HPP
+
+#include "ch_table.hpp"
+#include "csr_graph.hpp"
+#include "dbl_acc.hpp"
+#include "out_buffer.hpp"
+#include "quantile_acc.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <utility>
+#include <vector>
+
+/**
+ * The factor of the Euclidean lower bound of the distances: the
+ * lowest ratio of the weight of an arc to the distance between the
+ * locations of its vertexes.  It's 0 (no bound) if the graph has no
+ * locations.  For the Gabriel graph, whose weights are the rounded
+ * distances, the factor is close to 1.
+ */
+double
+euclid_factor(const csr_graph &g);
+
+/**
+ * The point-to-point shortest-path search: the A* search with the
+ * Euclidean lower bound, or Dijkstra's search if the factor of the
+ * bound is 0.  The bound is consistent, since the factor is not
+ * larger than the ratio of the weight to the distance of any arc, so
+ * the search stops as soon as the target is taken from the heap.  The
+ * vertexes are stamped with the number of the search, so that a
+ * search doesn't have to clear the arrays.  A thread should have one
+ * object, and run it for many queries.
+ */
+class point_search
+{
+public:
+  typedef csr_graph::vertex_type vertex_type;
+
+  point_search(const csr_graph &g, double factor);
+
+  /// Find the shortest path from s to t, and return its length, or
+  /// infinity if there is no path.
+  COST
+  run(vertex_type s, vertex_type t);
+
+  /// The hops of the path found.
+  std::uint32_t
+  hops() const
+  {
+    return m_path_hops;
+  }
+
+  /// The number of the vertexes taken from the heap by the search.
+  std::uint32_t
+  settled() const
+  {
+    return m_settled;
+  }
+
+private:
+  // The lower bound of the distance from v to the target.
+  COST
+  bound(vertex_type v) const;
+
+  const csr_graph &m_g;
+  double m_factor;
+  location m_target;
+
+  std::vector<COST> m_dist;
+  std::vector<std::uint32_t> m_hops;
+  std::vector<std::uint32_t> m_stamp;
+  std::uint32_t m_time = 0;
+  std::vector<std::pair<COST, vertex_type>> m_heap;
+
+  std::uint32_t m_path_hops = 0;
+  std::uint32_t m_settled = 0;
+};
+
+/**
+ * The histogram of the query latencies: bucket i counts the queries
+ * that took less than 2^i microseconds, and at least half that.
+ */
+struct latency_histogram
+{
+  std::vector<std::uint64_t> buckets;
+
+  void
+  operator()(double us);
+
+  void
+  merge(const latency_histogram &h);
+};
+
+/**
+ * The summary of the queries answered.
+ */
+struct query_summary
+{
+  // The latency in microseconds.
+  quantile_acc latency;
+  latency_histogram histogram;
+
+  // The vertexes settled by a search.
+  dbl_acc settled;
+
+  // The number of the queries without a path.
+  std::uint64_t unreachable = 0;
+};
+
+/**
+ * Answer the queries read from the stream: a line has the source and
+ * the destination, either as the bare vertex numbers (from 0), or as
+ * the names that netgen writes ("v" followed by the number from 1).
+ * The blank lines and the lines starting with '#' are skipped.
+ *
+ * The queries are read in batches of the lines ready, and a batch is
+ * answered in parallel on the given number of threads, and flushed.
+ * The answers are written in the order of the queries, a line per
+ * query with the source, the destination (as they were given), the
+ * length and the hops of the shortest path, or "inf" for both if
+ * there is no path.  Throws std::runtime_error on a bad query.
+ *
+ * The queries are answered on the contraction hierarchy of the
+ * graph if it's given, with the hops of the unpacked path, and
+ * otherwise with the point-to-point search.
+ */
+query_summary
+answer_queries(const csr_graph &g, const ch_table *ch, std::istream &in,
+               out_buffer &out, unsigned threads);
+
+#endif /* QUERY_HPP */
@@ -3,6 +3,8 @@
 
 #include "graph.hpp"
 #include "cli_args.hpp"
+#include "philox.hpp"
+#include "union_find.hpp"
 #include "utils.hpp"
 
 #include <boost/range.hpp>
@@ -16,13 +18,19 @@
 
 using namespace std;
 
+/**
+ * Set the edge distances.  The distance of the i-th edge is drawn
+ * from the i-th block of the counter-based engine, so the distances
+ * do not depend on the order in which they are set.
+ */
 template<typename T>
 void
-set_distances(graph &g, int min, int max, T &eng)
+set_distances(graph &g, int min, int max, const T &eng)
 {
-  std::uniform_int_distribution<> rng(min, max);
+  std::uint64_t i = 0;
   for (const auto &e: boost::make_iterator_range(boost::edges(g)))
-    boost::get(boost::edge_weight, g, e) = rng(eng);
+    boost::get(boost::edge_weight, g, e) =
+      min + scale_to(eng.block(i++)[0], max - min + 1);
 }
 
 /**
@@ -42,7 +50,7 @@ move_if_needed(vertex v, const graph &g, std::set<vertex> &connected,
                std::set<vertex> &saturated);
 
 /**
- * Add a random edge.
+ * Add a random edge, and unite its vertexes in the union-find.
  * @return true on success, false otherwise.
  */
 template<typename T>
@@ -50,7 +58,7 @@ bool
 add_random_edge(graph &g, std::set<vertex> &lonely,
                 std::set<vertex> &connected,
                 std::set<vertex> &saturated,
-                T &eng)
+                union_find &uf, T &eng)
 {
   // The condition for the first edge ever created in the graph.
   if (lonely.size() >= 2 && connected.empty() && saturated.empty())
@@ -64,6 +72,7 @@ add_random_edge(graph &g, std::set<vertex> &lonely,
       move(dst, g, lonely, connected, saturated);
       bool status = add_edge(src, dst, g).second;
       assert(status);
+      uf.unite(src, dst);
       return status;
     }
   // The condition for lonely vertexes and a connected component.
@@ -75,6 +84,7 @@ add_random_edge(graph &g, std::set<vertex> &lonely,
       vertex dst = get_random_element(connected, eng);
       bool status = add_edge(src, dst, g).second;
       assert(status);
+      uf.unite(src, dst);
       move(src, g, lonely, connected, saturated);
       move_if_needed(dst, g, connected, saturated);
       return status;
@@ -95,6 +105,7 @@ add_random_edge(graph &g, std::set<vertex> &lonely,
       vertex dst = get_random_element(sifted, eng);
       bool status = boost::add_edge(src, dst, g).second;
       assert(status);
+      uf.unite(src, dst);
       move_if_needed(src, g, connected, saturated);
       move_if_needed(dst, g, connected, saturated);
       return status;
@@ -103,17 +114,22 @@ add_random_edge(graph &g, std::set<vertex> &lonely,
   return false;
 }
 
+// The streams of the random graph generator.
+enum random_stream {topology_stream, distance_stream};
+
 /**
  * Generate the graph.  The graph has one connected component, but
  * there can be some lone vertexes.  We don't allow loop edges
  * (i.e. that start and end at some node), and we don't allow parallel
- * edges.
+ * edges.  The engine is a counter-based engine (like philox), which
+ * is split into the streams for the topology and the distances.  The
+ * union-find tracks the components as the edges are added.
  *
  * @return the number of edges actually created.
  */
 template<typename T>
 graph
-generate_random_graph(const cli_args &args, T &eng)
+generate_random_graph(const cli_args &args, const T &eng, union_find &uf)
 {
   assert(args.nr_nodes >= 2);
   assert(args.nr_edges.get() >= 0);
@@ -130,9 +146,13 @@ generate_random_graph(const cli_args &args, T &eng)
   // every other node with a single edge.
   std::set<vertex> saturated;
 
+  // The edges are drawn sequentially from their own stream.
+  T topology = eng.split(topology_stream);
+  uf.reset(args.nr_nodes);
+
   // In every iteration we add a new random edge.
   for (int created = 0; created < args.nr_edges.get(); ++created)
-    if (!add_random_edge(g, lonely, connected, saturated, eng))
+    if (!add_random_edge(g, lonely, connected, saturated, uf, topology))
       {
         assert(lonely.empty());
         assert(connected.size() <= 1);
@@ -144,7 +164,7 @@ generate_random_graph(const cli_args &args, T &eng)
   // Make sure we created the requested number of edges.
   assert(num_edges (g) == args.nr_edges.get());
 
-  set_distances(g, 1, 50, eng);
+  set_distances(g, 1, 50, eng.split(distance_stream));
 
   return g;
 }
@@ -0,0 +1,482 @@
+#include "read_graph.hpp"
+
+#include "bin_graph.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+  // The vertex declaration (with v empty), or the edge.
+  struct record
+  {
+    string_view u;
+    string_view v;
+    COST w;
+  };
+
+  // The records parsed from a chunk of lines, or the parse error
+  // with the position of the line where it was found.
+  struct chunk
+  {
+    const char *first;
+    const char *last;
+    vector<record> records;
+    string error;
+    const char *error_line = nullptr;
+  };
+
+  // The exception thrown on a parse error within a line.
+  struct parse_error
+  {
+    const char *what;
+  };
+
+  bool
+  blank(char c)
+  {
+    return c == ' ' || c == '\t' || c == '\r';
+  }
+
+  void
+  skip_blanks(const char *&p, const char *e)
+  {
+    while (p != e && blank(*p))
+      ++p;
+  }
+
+  bool
+  id_char(char c)
+  {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+  }
+
+  /**
+   * Parse the DOT identifier: a quoted string (the text between the
+   * quotes is the identifier), or a word, or a number.
+   */
+  string_view
+  dot_id(const char *&p, const char *e)
+  {
+    const char *b = p;
+
+    if (p != e && *p == '"')
+      {
+        for (++p; p != e && *p != '"'; ++p)
+          if (*p == '\\' && p + 1 != e)
+            ++p;
+        if (p == e)
+          throw parse_error{"unterminated quoted identifier"};
+        return string_view(b + 1, p++ - b - 1);
+      }
+
+    if (p != e && *p == '-')
+      ++p;
+    while (p != e && id_char(*p))
+      ++p;
+
+    if (p == b)
+      throw parse_error{"identifier expected"};
+
+    return string_view(b, p - b);
+  }
+
+  COST
+  parse_weight(string_view s)
+  {
+    COST w;
+    auto r = from_chars(s.data(), s.data() + s.size(), w);
+    if (r.ec != errc() || r.ptr != s.data() + s.size())
+      throw parse_error{"bad weight"};
+    return w;
+  }
+
+  /**
+   * Parse the DOT attribute list, which starts at '[', and return
+   * the weight, if given.
+   */
+  void
+  dot_attrs(const char *&p, const char *e, COST &w)
+  {
+    for (++p;;)
+      {
+        skip_blanks(p, e);
+        if (p == e)
+          throw parse_error{"unterminated attribute list"};
+        if (*p == ']')
+          {
+            ++p;
+            return;
+          }
+        if (*p == ',' || *p == ';')
+          {
+            ++p;
+            continue;
+          }
+
+        string_view key = dot_id(p, e);
+        skip_blanks(p, e);
+        if (p == e || *p != '=')
+          throw parse_error{"'=' expected"};
+        ++p;
+        skip_blanks(p, e);
+        string_view value = dot_id(p, e);
+
+        if (key == "weight")
+          w = parse_weight(value);
+      }
+  }
+
+  void
+  parse_dot_line(const char *p, const char *e, vector<record> &rs)
+  {
+    skip_blanks(p, e);
+    if (p == e || *p == '#' || (e - p >= 2 && p[0] == '/' && p[1] == '/'))
+      return;
+
+    while (true)
+      {
+        skip_blanks(p, e);
+        if (p == e)
+          return;
+
+        if (*p == '{' || *p == '}' || *p == ';')
+          {
+            ++p;
+            continue;
+          }
+
+        bool quoted = *p == '"';
+        string_view id = dot_id(p, e);
+
+        // The graph header, or the default attribute statement: skip
+        // it up to the opening brace or the end of the statement.
+        if (!quoted && (id == "graph" || id == "digraph" || id == "strict" ||
+                        id == "subgraph" || id == "node" || id == "edge"))
+          {
+            while (p != e && *p != '{' && *p != ';')
+              if (*p == '[')
+                {
+                  COST ignored;
+                  dot_attrs(p, e, ignored);
+                }
+              else
+                ++p;
+            continue;
+          }
+
+        skip_blanks(p, e);
+
+        // The graph attribute statement, e.g., rankdir = LR.
+        if (p != e && *p == '=')
+          {
+            ++p;
+            skip_blanks(p, e);
+            dot_id(p, e);
+            continue;
+          }
+
+        // The edge statement, possibly a chain of edges.
+        vector<string_view> chain(1, id);
+        while (e - p >= 2 && p[0] == '-' && (p[1] == '-' || p[1] == '>'))
+          {
+            p += 2;
+            skip_blanks(p, e);
+            chain.push_back(dot_id(p, e));
+            skip_blanks(p, e);
+          }
+
+        COST w = 1;
+        if (p != e && *p == '[')
+          dot_attrs(p, e, w);
+
+        if (chain.size() == 1)
+          rs.push_back(record{id, string_view(), 0});
+        else
+          for (size_t i = 1; i < chain.size(); ++i)
+            rs.push_back(record{chain[i - 1], chain[i], w});
+      }
+  }
+
+  string_view
+  token(const char *&p, const char *e)
+  {
+    skip_blanks(p, e);
+    const char *b = p;
+    while (p != e && !blank(*p))
+      ++p;
+    return string_view(b, p - b);
+  }
+
+  void
+  parse_edges_line(const char *p, const char *e, vector<record> &rs)
+  {
+    skip_blanks(p, e);
+    if (p == e || *p == '#' || *p == '%')
+      return;
+
+    string_view u = token(p, e);
+    string_view v = token(p, e);
+    if (v.empty())
+      throw parse_error{"two vertexes expected"};
+
+    string_view w = token(p, e);
+    rs.push_back(record{u, v, w.empty() ? 1 : parse_weight(w)});
+
+    if (!token(p, e).empty())
+      throw parse_error{"unexpected text after the weight"};
+  }
+
+  // True if the text starts with a DOT graph keyword.
+  bool
+  looks_like_dot(const char *p, const char *e)
+  {
+    // Skip the blank and the comment lines.
+    while (p != e)
+      {
+        while (p != e && isspace(static_cast<unsigned char>(*p)))
+          ++p;
+        if (p != e && (*p == '#' || *p == '%' || *p == '/'))
+          p = find(p, e, '\n');
+        else
+          break;
+      }
+
+    const char *b = p;
+    while (p != e && isalpha(static_cast<unsigned char>(*p)))
+      ++p;
+    string_view word(b, p - b);
+
+    return word == "graph" || word == "digraph" || word == "strict";
+  }
+
+  /**
+   * The number in the name: the bare number (style 0), or the
+   * number after "v" (style 1).
+   *
+   * @return the style, or -1 if the name is not like that
+   */
+  int
+  name_number(string_view s, uint64_t &x)
+  {
+    int style = 0;
+    if (!s.empty() && s[0] == 'v')
+      {
+        style = 1;
+        s.remove_prefix(1);
+      }
+
+    if (s.empty() || !isdigit(static_cast<unsigned char>(s[0])))
+      return -1;
+
+    auto r = from_chars(s.data(), s.data() + s.size(), x);
+    if (r.ec != errc() || r.ptr != s.data() + s.size())
+      return -1;
+
+    // The "v" names are counted from 1.
+    if (style == 1 && x == 0)
+      return -1;
+
+    return style;
+  }
+
+  /**
+   * Find the common style and the largest number of the names in
+   * the chunk.
+   *
+   * @return the style, -1 for no names, or -2 for the mixed styles
+   */
+  int
+  chunk_style(const chunk &c, uint64_t &max)
+  {
+    int style = -1;
+    max = 0;
+
+    for (const record &r: c.records)
+      for (string_view s: {r.u, r.v})
+        {
+          if (s.data() == nullptr)
+            continue;
+          uint64_t x;
+          int st = name_number(s, x);
+          if (st < 0 || (style >= 0 && st != style))
+            return -2;
+          style = st;
+          max = std::max(max, x);
+        }
+
+    return style;
+  }
+}
+
+csr_graph
+read_graph(const string &path, unsigned threads)
+{
+  mapped_file mf(path);
+
+  if (is_bin_graph(mf.data(), mf.size()))
+    return load_bin(path);
+
+  const char *first = mf.data();
+  const char *last = first + mf.size();
+  bool dot = looks_like_dot(first, last);
+
+  // Split the text into the chunks of whole lines, a few per thread,
+  // but not smaller than 64 KiB.
+  threads = nr_threads(threads);
+  size_t nr_chunks = std::max<size_t>(1, std::min<size_t>
+                                      (mf.size() >> 16, 8 * threads));
+  vector<chunk> chunks(nr_chunks);
+  const char *p = first;
+  for (size_t i = 0; i < nr_chunks; ++i)
+    {
+      chunks[i].first = p;
+      if (i + 1 < nr_chunks)
+        {
+          p = std::max(p, first + mf.size() / nr_chunks * (i + 1));
+          p = std::min(find(p, last, '\n') + 1, last);
+        }
+      else
+        p = last;
+      chunks[i].last = p;
+    }
+
+  parallel_for(nr_chunks, threads, [&](size_t i, unsigned)
+    {
+      chunk &c = chunks[i];
+      for (const char *l = c.first; l != c.last;)
+        {
+          const char *le = find(l, c.last, '\n');
+          try
+            {
+              if (dot)
+                parse_dot_line(l, le, c.records);
+              else
+                parse_edges_line(l, le, c.records);
+            }
+          catch (const parse_error &e)
+            {
+              c.error = e.what;
+              c.error_line = l;
+              return;
+            }
+          l = le == c.last ? le : le + 1;
+        }
+    });
+
+  for (const chunk &c: chunks)
+    if (c.error_line)
+      throw runtime_error(path + ":" +
+                          to_string(count(first, c.error_line, '\n') + 1)
+                          + ": " + c.error);
+
+  // Try to take the vertex numbers from the names.
+  vector<int> styles(nr_chunks);
+  vector<uint64_t> maxes(nr_chunks);
+  parallel_for(nr_chunks, threads, [&](size_t i, unsigned)
+               {styles[i] = chunk_style(chunks[i], maxes[i]);});
+
+  int style = -1;
+  uint64_t max = 0;
+  for (size_t i = 0; i < nr_chunks; ++i)
+    if (styles[i] != -1)
+      {
+        if (styles[i] == -2 || (style >= 0 && styles[i] != style))
+          {
+            style = -2;
+            break;
+          }
+        style = styles[i];
+        max = std::max(max, maxes[i]);
+      }
+
+  // The numbers give the vertexes only if they are dense, i.e., all
+  // the numbers up to the largest are used, so that no vertexes are
+  // made up.  There can't be more numbers than the names.
+  if (style >= 0)
+    {
+      uint64_t n = style == 0 ? max + 1 : max;
+      uint64_t names = 0;
+      for (const chunk &c: chunks)
+        for (const record &r: c.records)
+          names += r.v.data() ? 2 : 1;
+
+      uint64_t used = 0;
+      if (n <= names)
+        {
+          vector<char> seen(n, 0);
+          for (const chunk &c: chunks)
+            for (const record &r: c.records)
+              for (string_view s: {r.u, r.v})
+                if (s.data())
+                  {
+                    uint64_t x;
+                    name_number(s, x);
+                    used += !seen[x - style];
+                    seen[x - style] = 1;
+                  }
+        }
+
+      if (used != n)
+        style = -2;
+    }
+
+  csr_builder b;
+
+  if (style >= 0)
+    {
+      // The vertexes named with the numbers.
+      uint64_t n = style == 0 ? max + 1 : max;
+      if (n >= UINT32_MAX)
+        throw runtime_error(path + ": too many vertexes");
+      b.reset(n);
+
+      for (const chunk &c: chunks)
+        for (const record &r: c.records)
+          if (r.v.data())
+            {
+              uint64_t u, v;
+              name_number(r.u, u);
+              name_number(r.v, v);
+              b.add_edge(u - style, v - style, r.w);
+            }
+    }
+  else
+    {
+      // The vertexes numbered in the order of their appearance.
+      unordered_map<string_view, csr_graph::vertex_type> ids;
+
+      auto id = [&](string_view s)
+        {
+          auto i = ids.emplace(s, ids.size());
+          if (ids.size() >= UINT32_MAX)
+            throw runtime_error(path + ": too many vertexes");
+          return i.first->second;
+        };
+
+      vector<tuple<csr_graph::vertex_type, csr_graph::vertex_type, COST>>
+        edges;
+      for (const chunk &c: chunks)
+        for (const record &r: c.records)
+          {
+            csr_graph::vertex_type u = id(r.u);
+            if (r.v.data())
+              edges.emplace_back(u, id(r.v), r.w);
+          }
+
+      b.reset(ids.size());
+      for (const auto &e: edges)
+        b.add_edge(get<0>(e), get<1>(e), get<2>(e));
+    }
+
+  return b.build();
+}
@@ -0,0 +1,33 @@
+#ifndef READ_GRAPH_HPP
+#define READ_GRAPH_HPP
+
+#include "csr_graph.hpp"
+
+#include <string>
+
+/**
+ * Read the graph from the file, which can be in the binary format,
+ * in DOT, or an edge list.  The format is recognized by the content:
+ * the binary format by its magic number, and DOT by the "graph",
+ * "digraph" or "strict" keyword it starts with.
+ *
+ * The text formats are parsed in parallel chunks of lines with the
+ * given number of threads.  In DOT, a statement cannot span lines.
+ * The node statements declare the vertexes, the edge statements give
+ * the edges (the "->" arcs are taken as undirected edges), and the
+ * "weight" attribute gives the weight, 1 by default.  An edge list
+ * has an edge per line: the two vertexes and an optional weight; the
+ * lines starting with '#' or '%' are comments.
+ *
+ * The vertexes are numbered in the order of their first appearance.
+ * However, if all the names are either the bare numbers from 0, or
+ * "v" followed by the numbers from 1 (as netgen writes them), and
+ * all the numbers up to the largest are used, the numbers give the
+ * vertexes directly, without a look-up.
+ *
+ * Throws std::runtime_error on a parse error.
+ */
+csr_graph
+read_graph(const std::string &path, unsigned threads);
+
+#endif /* READ_GRAPH_HPP */
@@ -0,0 +1,100 @@
+#include "route_table.hpp"
+#include "bin_graph.hpp"
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+static const char route_magic[8] = {'N', 'G', 'R', 'O', 'U', 'T', 'E', 0};
+
+constexpr uint16_t route_set::none;
+
+void
+write_routes(out_buffer &out, const route_set &s)
+{
+  uint64_t n = s.offsets.size() - 1;
+  uint64_t r = s.nr_runs();
+
+  route_header h = {};
+  memcpy(h.magic, route_magic, sizeof(h.magic));
+  h.version = route_version;
+  h.byte_order = 0x01020304;
+  h.nr_vertices = n;
+  h.nr_runs = r;
+
+  uint64_t pos = align8(sizeof(route_header));
+  h.offsets = pos;
+  pos += align8((n + 1) * sizeof(uint64_t));
+  h.starts = pos;
+  pos += align8(r * sizeof(uint32_t));
+  h.slots = pos;
+  pos += align8(r * sizeof(uint16_t));
+  h.size = pos;
+
+  put_array(out, &h, 1);
+  put_array(out, s.offsets.data(), n + 1);
+  put_array(out, s.starts.data(), r);
+  put_array(out, s.slots.data(), r);
+}
+
+route_table::route_table(const string &path, const csr_graph &g):
+  m_g(g), m_file(make_shared<mapped_file>(path))
+{
+  const char *base = m_file->data();
+
+  try
+    {
+      const route_header &h = check_header<route_header>
+        (base, m_file->size(), route_magic, route_version,
+         "route table");
+      if (h.nr_vertices >= UINT32_MAX || h.nr_runs > h.size)
+        throw runtime_error("bad table size");
+
+      uint64_t n = h.nr_vertices;
+      uint64_t r = h.nr_runs;
+      check_section(sizeof(h), h.size, h.offsets,
+                    (n + 1) * sizeof(uint64_t), "offsets");
+      check_section(sizeof(h), h.size, h.starts, r * sizeof(uint32_t),
+                    "starts");
+      check_section(sizeof(h), h.size, h.slots, r * sizeof(uint16_t),
+                    "slots");
+
+      m_h = &h;
+      m_offsets = reinterpret_cast<const uint64_t *>(base + h.offsets);
+      m_starts = reinterpret_cast<const uint32_t *>(base + h.starts);
+      m_slots = reinterpret_cast<const uint16_t *>(base + h.slots);
+
+      if (n != g.nr_vertices())
+        throw runtime_error("not the routes of the graph");
+      check_offsets(m_offsets, n, r, "offsets");
+
+      for (uint64_t u = 0; u < n; ++u)
+        for (uint64_t i = m_offsets[u]; i < m_offsets[u + 1]; ++i)
+          {
+            if (i == m_offsets[u] ? m_starts[i] != 0 :
+                m_starts[i] <= m_starts[i - 1] || m_starts[i] >= n)
+              throw runtime_error("bad starts");
+            if (m_slots[i] != route_set::none &&
+                m_slots[i] >= g.degree(u))
+              throw runtime_error("bad slots");
+          }
+    }
+  catch (const runtime_error &e)
+    {
+      throw runtime_error(path + ": " + e.what());
+    }
+}
+
+uint16_t
+route_table::slot(vertex_type u, vertex_type d) const
+{
+  // The last run that starts at d or before.
+  const uint32_t *b = m_starts + m_offsets[u];
+  const uint32_t *e = m_starts + m_offsets[u + 1];
+  const uint32_t *i = upper_bound(b, e, d);
+
+  return i == b ? route_set::none : m_slots[i - 1 - m_starts];
+}
@@ -0,0 +1,144 @@
+#ifndef ROUTE_TABLE_HPP
+#define ROUTE_TABLE_HPP
+
+#include "csr_graph.hpp"
+#include "out_buffer.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class mapped_file;
+
+/**
+ * The next-hop routing tables of the vertexes, compressed with the
+ * run-length encoding over the destinations: the destinations from
+ * one start to the next go through the same arc.  The arc is given
+ * by its slot among the arcs of the vertex, so that the next hop of
+ * vertex u is the target of arc offset(u) + slot of the graph.
+ *
+ * The runs of vertex u are from offsets[u] to offsets[u + 1] of
+ * starts and slots, and the first run starts at destination 0.  The
+ * destination u itself takes the slot of the run it falls in.  The
+ * unreachable destinations take slot none.
+ *
+ * The vertex order makes the runs long: the destinations close to
+ * one another in the graph, which are routed the same way, should
+ * have close numbers, like in the Hilbert order of the locations.
+ */
+struct route_set
+{
+  std::vector<std::uint64_t> offsets = {0};
+  std::vector<std::uint32_t> starts;
+  std::vector<std::uint16_t> slots;
+
+  /// The slot of the unreachable destinations.
+  static constexpr std::uint16_t none = UINT16_MAX;
+
+  /// The number of the runs.
+  std::uint64_t
+  nr_runs() const
+  {
+    return starts.size();
+  }
+};
+
+/**
+ * The header of the route table format.  The file is made of the
+ * header and the sections:
+ *
+ * - the offsets: nr_vertices + 1 numbers of uint64_t,
+ *
+ * - the starts: nr_runs numbers of uint32_t,
+ *
+ * - the slots: nr_runs numbers of uint16_t.
+ *
+ * Like in the binary graph format, the numbers are in the byte order
+ * of the writer, and every section starts at a multiple of 8 bytes,
+ * so that a mapped file can be used in place.
+ */
+struct route_header
+{
+  // The magic number, "NGROUTE" followed by a zero.
+  char magic[8];
+  // The version of the format.
+  std::uint32_t version;
+  // The number 0x01020304 as written by the writer.
+  std::uint32_t byte_order;
+
+  std::uint64_t nr_vertices;
+  std::uint64_t nr_runs;
+
+  // The positions of the sections in the file.
+  std::uint64_t offsets;
+  std::uint64_t starts;
+  std::uint64_t slots;
+
+  // The size of the file.
+  std::uint64_t size;
+};
+
+// The version of the route table format written.
+constexpr std::uint32_t route_version = 1;
+
+/**
+ * Write the routing tables in the route table format.
+ */
+void
+write_routes(out_buffer &out, const route_set &s);
+
+/**
+ * The route table mapped into memory, with the graph whose arcs its
+ * slots refer to.  Nothing is copied, and the file stays mapped for
+ * as long as the table lives.
+ */
+class route_table
+{
+public:
+  typedef csr_graph::vertex_type vertex_type;
+
+  /// Map the file of the routes of graph g, and check the runs in a
+  /// linear pass: the starts of a vertex have to increase from 0, and
+  /// the slots have to be the arcs of the vertex.  Throws
+  /// std::runtime_error if the file cannot be mapped, is not valid,
+  /// or is not of the graph.
+  route_table(const std::string &path, const csr_graph &g);
+
+  std::uint64_t
+  nr_vertices() const
+  {
+    return m_h->nr_vertices;
+  }
+
+  std::uint64_t
+  nr_runs() const
+  {
+    return m_h->nr_runs;
+  }
+
+  /// The slot of the arc of vertex u toward destination d, or
+  /// route_set::none.  Takes O(log r) time for the r runs of u.
+  std::uint16_t
+  slot(vertex_type u, vertex_type d) const;
+
+  /// The next hop of vertex u toward destination d, or
+  /// csr_graph::null_vertex() if d is unreachable.
+  vertex_type
+  next_hop(vertex_type u, vertex_type d) const
+  {
+    std::uint16_t s = slot(u, d);
+    return s == route_set::none ? csr_graph::null_vertex() :
+      m_g.targets()[m_g.offset(u) + s];
+  }
+
+private:
+  csr_graph m_g;
+  std::shared_ptr<const mapped_file> m_file;
+  const route_header *m_h;
+  const std::uint64_t *m_offsets;
+  const std::uint32_t *m_starts;
+  const std::uint16_t *m_slots;
+};
+
+#endif /* ROUTE_TABLE_HPP */
@@ -0,0 +1,65 @@
+#include "routes.hpp"
+
+#include "parallel.hpp"
+#include "sssp.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+typedef csr_graph::vertex_type vertex_type;
+
+route_set
+find_routes(const csr_graph &g, unsigned threads)
+{
+  vertex_type n = g.nr_vertices();
+
+  for (vertex_type v = 0; v < n; ++v)
+    if (g.degree(v) > route_set::none)
+      throw runtime_error("Vertex " + to_string(v) + " has too many "
+                          "links for the route table.");
+
+  // The runs of every source, merged in the order of the sources.
+  vector<vector<uint32_t>> starts(n);
+  vector<vector<uint16_t>> slots(n);
+
+  threads = min<size_t>(nr_threads(threads), max<size_t>(n, 1));
+  vector<sssp> sps(threads);
+
+  parallel_for(n, threads, [&](size_t u, unsigned t)
+    {
+      sssp &sp = sps[t];
+      sp.run(g, u);
+
+      // The source itself extends the run it falls in.
+      for (vertex_type d = 0; d < n; ++d)
+        if (d != u)
+          {
+            uint32_t f = sp.first(d);
+            uint16_t s = f == sssp::none ? route_set::none : f;
+            if (slots[u].empty() || s != slots[u].back())
+              {
+                starts[u].push_back(slots[u].empty() ? 0 : d);
+                slots[u].push_back(s);
+              }
+          }
+
+      starts[u].shrink_to_fit();
+      slots[u].shrink_to_fit();
+    });
+
+  route_set r;
+  r.offsets.reserve(n + 1);
+  for (vertex_type u = 0; u < n; ++u)
+    {
+      r.starts.insert(r.starts.end(), starts[u].begin(), starts[u].end());
+      r.slots.insert(r.slots.end(), slots[u].begin(), slots[u].end());
+      r.offsets.push_back(r.nr_runs());
+      vector<uint32_t>().swap(starts[u]);
+      vector<uint16_t>().swap(slots[u]);
+    }
+
+  return r;
+}
@@ -0,0 +1,22 @@
+#ifndef ROUTES_HPP
+#define ROUTES_HPP
+
+#include "csr_graph.hpp"
+#include "route_table.hpp"
+
+/**
+ * Find the next-hop routing tables of the shortest-path routing.  For
+ * every source, the shortest paths are found, and the first hops of
+ * the paths to the destinations, which the search keeps along with
+ * the distances, are run-length encoded.  Of the shortest paths, the
+ * one with the lowest first slot is taken, so the next hops of the
+ * vertexes on the way make a shortest path too.
+ *
+ * The sources are run in parallel on the given number of threads, and
+ * the result doesn't depend on the number of threads.  Throws
+ * std::runtime_error if a vertex has more arcs than a slot can number.
+ */
+route_set
+find_routes(const csr_graph &g, unsigned threads);
+
+#endif /* ROUTES_HPP */
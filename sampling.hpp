@@ -0,0 +1,155 @@
+#ifndef SAMPLING_HPP
+#define SAMPLING_HPP
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * A uniform random number from the open interval (0, 1), made of
+ * the 53 bits of two 32-bit values.
+ */
+template <typename E>
+double
+uniform_open(E &eng)
+{
+  std::uint64_t x = std::uint64_t(eng()) << 21 ^ eng() >> 11;
+  return (x + 0.5) / 9007199254740992.0;
+}
+
+/**
+ * Select n of the numbers 0, ..., N - 1 uniformly at random, and
+ * call select(i) for each selected i in the increasing order.  This
+ * is the sequential random sampling of Vitter's Method D ("An
+ * Efficient Algorithm for Sequential Random Sampling", ACM TOMS,
+ * 1987): the distance to the next selected number is drawn directly,
+ * so the time is O(n) on average, and the memory is O(1).  When n is
+ * a large fraction of N, the simpler Method A takes over.
+ */
+template <typename E, typename F>
+void
+sample_sorted(std::uint64_t n, std::uint64_t N, E &eng, F select)
+{
+  assert(n <= N);
+
+  // The next candidate number.
+  std::uint64_t next = 0;
+
+  // Skip s numbers, and select the next one.
+  auto skip_select = [&](std::uint64_t s)
+    {
+      next += s;
+      select(next++);
+    };
+
+  // Method D, while the sample is sparse.
+  const double alpha_inv = 13;
+  double threshold = alpha_inv * n;
+
+  if (n > 1 && threshold < N)
+    {
+      double ninv = 1.0 / n;
+      double v_prime = std::exp(std::log(uniform_open(eng)) * ninv);
+      double qu1 = double(N) - n + 1;
+
+      while (n > 1 && threshold < N)
+        {
+          double nmin1inv = 1.0 / (n - 1.0);
+          double x;
+          std::uint64_t s;
+
+          while (true)
+            {
+              // Step D2: generate X, and U.
+              while (true)
+                {
+                  x = N * (1.0 - v_prime);
+                  s = x;
+                  if (s < qu1)
+                    break;
+                  v_prime = std::exp(std::log(uniform_open(eng)) * ninv);
+                }
+
+              double u = uniform_open(eng);
+
+              // Step D3: the quick acceptance test.
+              double y1 = std::exp(std::log(u * N / qu1) * nmin1inv);
+              v_prime = y1 * (1.0 - x / N) * (qu1 / (qu1 - s));
+              if (v_prime <= 1.0)
+                break;
+
+              // Step D4: the exact acceptance test.
+              double y2 = 1.0;
+              double top = N - 1.0;
+              double bottom, limit;
+              if (n - 1 > s)
+                {
+                  bottom = double(N) - n;
+                  limit = double(N) - s;
+                }
+              else
+                {
+                  bottom = double(N) - s - 1.0;
+                  limit = qu1;
+                }
+              for (double t = N - 1.0; t >= limit; --t)
+                {
+                  y2 = y2 * top / bottom;
+                  --top;
+                  --bottom;
+                }
+
+              if (N / (N - x) >= y1 * std::exp(std::log(y2) * nmin1inv))
+                {
+                  v_prime = std::exp(std::log(uniform_open(eng)) *
+                                     nmin1inv);
+                  break;
+                }
+
+              v_prime = std::exp(std::log(uniform_open(eng)) * ninv);
+            }
+
+          // Step D5: select the number.
+          skip_select(s);
+          N -= s + 1;
+          --n;
+          ninv = nmin1inv;
+          qu1 -= s;
+          threshold -= alpha_inv;
+        }
+
+      if (n == 1)
+        {
+          skip_select(std::uint64_t(N * v_prime));
+          return;
+        }
+    }
+
+  // Method A, for the dense sample, and the last numbers.
+  if (!n)
+    return;
+
+  double top = double(N) - n;
+  double nreal = N;
+
+  while (n >= 2)
+    {
+      double v = uniform_open(eng);
+      std::uint64_t s = 0;
+      double quot = top / nreal;
+      while (quot > v)
+        {
+          ++s;
+          --top;
+          --nreal;
+          quot = quot * top / nreal;
+        }
+      skip_select(s);
+      --nreal;
+      --n;
+    }
+
+  skip_select(std::uint64_t(nreal * uniform_open(eng)));
+}
+
+#endif /* SAMPLING_HPP */
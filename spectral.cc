@@ -0,0 +1,339 @@
+#include "spectral.hpp"
+
+#include "parallel.hpp"
+#include "sampling.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+using namespace std;
+
+typedef csr_graph::vertex_type vertex_type;
+
+// The number of the vertexes a thread takes at a time.
+static const size_t block = 4096;
+
+// The relative residual of the converged eigenvalue.
+static const double tolerance = 1e-6;
+
+// The limit of the iterations.
+static const uint32_t max_iterations = 20000;
+
+namespace
+{
+  /**
+   * The symmetric tridiagonal matrix of the Lanczos iteration, with
+   * the diagonal a and the off-diagonal b.
+   */
+  struct tridiagonal
+  {
+    vector<double> a;
+    vector<double> b;
+
+    // The number of the eigenvalues smaller than x (Sturm).  The
+    // ratios d of the leading principal minors of T - x I change
+    // sign at every eigenvalue.
+    size_t
+    count(double x) const
+    {
+      size_t c = 0;
+      double d = 1;
+      for (size_t i = 0; i < a.size(); ++i)
+        {
+          d = a[i] - x - (i ? b[i - 1] * b[i - 1] / d : 0);
+          if (d == 0)
+            d = -numeric_limits<double>::min();
+          c += d < 0;
+        }
+      return c;
+    }
+
+    // The largest eigenvalue, not smaller than lo, by bisection.  It
+    // is not smaller than the diagonal either, and not larger than the
+    // Gershgorin bound.
+    double
+    largest(double lo) const
+    {
+      double hi = lo;
+      for (size_t i = 0; i < a.size(); ++i)
+        {
+          lo = max(lo, a[i]);
+          hi = max(hi, a[i] + (i ? fabs(b[i - 1]) : 0) +
+                   (i + 1 < a.size() ? fabs(b[i]) : 0));
+        }
+
+      while (true)
+        {
+          double mid = lo + (hi - lo) / 2;
+          if (mid <= lo || mid >= hi)
+            return hi;
+          if (count(mid) == a.size())
+            hi = mid;
+          else
+            lo = mid;
+        }
+    }
+
+    // The last element of the normalized eigenvector of eigenvalue x.
+    // Its square is p(x) / q'(x), where p and q are the
+    // characteristic polynomials of T without its last row and column,
+    // and of T.  The derivative of the ratio of the minors is carried
+    // along with the ratio.
+    double
+    last(double x) const
+    {
+      double d = 1, dd = 0;
+      for (size_t i = 0; i < a.size(); ++i)
+        {
+          double r = i ? b[i - 1] * b[i - 1] / d : 0;
+          double nd = a[i] - x - r;
+          dd = -1 + (i ? r * dd / d : 0);
+          d = nd;
+          if (d == 0)
+            d = -numeric_limits<double>::min();
+        }
+      return 1 / sqrt(fabs(dd));
+    }
+  };
+
+  /**
+   * The parallel operations on the vectors, run on a pool of threads
+   * started once for all the iterations.  The sums are taken over the
+   * blocks, and then over the sums of the blocks in their order, so
+   * that they don't depend on the number of threads.
+   */
+  class vectors
+  {
+    size_t m_n;
+    vector<double> m_sums[2];
+    thread_pool m_pool;
+
+  public:
+    vectors(size_t n, unsigned threads):
+      m_n(n),
+      m_pool(min<size_t>(nr_threads(threads), (n + block - 1) / block))
+    {
+      for (auto &s: m_sums)
+        s.resize((n + block - 1) / block);
+    }
+
+    // Call f(j, k, s) for the indexes from j to k of every block, and
+    // return the sums of what the calls added to s[0] and s[1].
+    template <typename F>
+    pair<double, double>
+    sums(F f)
+    {
+      m_pool.run(m_sums[0].size(), [&](size_t b, unsigned)
+        {
+          double s[2] = {0, 0};
+          f(b * block, min(m_n, (b + 1) * block), s);
+          m_sums[0][b] = s[0];
+          m_sums[1][b] = s[1];
+        });
+
+      return make_pair(accumulate(m_sums[0].begin(), m_sums[0].end(), 0.0),
+                       accumulate(m_sums[1].begin(), m_sums[1].end(), 0.0));
+    }
+
+    // Call f(j, k) for the indexes from j to k of every block, and
+    // return the sum of what the calls returned.
+    template <typename F>
+    double
+    sum(F f)
+    {
+      return sums([&](size_t j, size_t k, double *s)
+                  {s[0] = f(j, k);}).first;
+    }
+  };
+
+  /**
+   * Find the largest eigenvalue of the symmetric matrix with the
+   * Lanczos iteration.  The product y = Mx for the indexes from j to
+   * k is product(x, y, j, k).  If deflate is true, the constant
+   * vector is projected out.  The residual has to be small relative
+   * to the distance of the eigenvalue from the origin.
+   *
+   * The Lanczos vectors are not reorthogonalized, so that only three
+   * of them are kept.  The lost orthogonality only brings the copies
+   * of the converged eigenvalues, and the largest eigenvalue of the
+   * tridiagonal matrix converges to the largest eigenvalue of M.  The
+   * eigenvalue has converged when its residual, estimated from the
+   * last element of its eigenvector in the tridiagonal matrix, is
+   * small, or when the tridiagonal matrix has its copy, since then the
+   * residual estimate fails.
+   */
+  template <typename P>
+  eigen_result
+  lanczos(vertex_type n, unsigned threads, const philox &eng, bool deflate,
+          double origin, P product)
+  {
+    eigen_result r = {0, 0, true};
+
+    vectors vs(n, threads);
+    vector<double> v(n), u(n), w(n);
+
+    // The random starting vector.
+    philox e = eng.split(spectral_stream);
+    for (double &x: v)
+      x = uniform_open(e) - 0.5;
+
+    // The mean of the vector to project out, found along with its
+    // norm, and subtracted when the vector is scaled.
+    double mean = 0;
+
+    // Subtract alpha v from x, and return the norm of x with the
+    // constant vector projected out, in a single pass.  The mean of
+    // the Lanczos vectors is only the rounding error, so the norm is
+    // accurate without subtracting the mean first.
+    auto orthogonalize = [&](vector<double> &x, double alpha)
+      {
+        auto [sum, squares] = vs.sums([&](size_t j, size_t k, double *s)
+          {
+            for (size_t i = j; i < k; ++i)
+              {
+                x[i] -= alpha * v[i];
+                s[0] += x[i];
+                s[1] += x[i] * x[i];
+              }
+          });
+
+        mean = deflate ? sum / n : 0;
+        return sqrt(max(0.0, squares - mean * sum));
+      };
+
+    // Project out the constant vector from x, and divide by the norm.
+    auto scale = [&](vector<double> &x, double norm)
+      {
+        vs.sum([&](size_t j, size_t k)
+          {
+            for (size_t i = j; i < k; ++i)
+              x[i] = (x[i] - mean) / norm;
+            return 0.0;
+          });
+      };
+
+    double beta = orthogonalize(v, 0);
+    if (beta == 0)
+      return r;
+    scale(v, beta);
+    beta = 0;
+
+    tridiagonal t;
+    double theta = -numeric_limits<double>::infinity();
+    uint32_t check = 10;
+
+    while (r.iterations < max_iterations)
+      {
+        // w = M v - beta u, and alpha = w . v.
+        double alpha = vs.sum([&](size_t j, size_t k)
+          {
+            product(v, w, j, k);
+            double s = 0;
+            for (size_t i = j; i < k; ++i)
+              {
+                w[i] -= beta * u[i];
+                s += w[i] * v[i];
+              }
+            return s;
+          });
+
+        beta = orthogonalize(w, alpha);
+
+        ++r.iterations;
+        t.a.push_back(alpha);
+
+        // The invariant subspace: the eigenvalue is exact.
+        bool exact = beta <= numeric_limits<double>::epsilon() *
+          fabs(alpha);
+
+        if (exact || r.iterations == check ||
+            r.iterations == max_iterations ||
+            r.iterations == n - deflate)
+          {
+            theta = t.largest(theta);
+            r.value = theta;
+
+            double residual = exact ? 0 : beta * t.last(theta);
+            // The copy of the eigenvalue, brought by the lost
+            // orthogonality, shows it has converged.
+            double tol = tolerance * fabs(theta - origin);
+            if (residual <= tol || t.count(theta - tol) + 2 <= t.a.size() ||
+                r.iterations == n - deflate)
+              return r;
+
+            check += max<uint32_t>(10, r.iterations / 16);
+          }
+
+        t.b.push_back(beta);
+
+        // Shift the vectors: u = v, v = w / beta.
+        swap(u, v);
+        swap(v, w);
+        scale(v, beta);
+      }
+
+    r.converged = false;
+    return r;
+  }
+}
+
+eigen_result
+algebraic_connectivity(const csr_graph &g, unsigned threads,
+                       const philox &eng)
+{
+  vertex_type n = g.nr_vertices();
+
+  // The zero eigenvalue has as many eigenvectors as there are
+  // components.
+  if (n < 2 || !is_connected(g))
+    return eigen_result{0, 0, true};
+
+  uint32_t dmax = 0;
+  for (vertex_type v = 0; v < n; ++v)
+    dmax = max(dmax, g.degree(v));
+  double c = 2.0 * dmax;
+
+  // y = (c I - L) x = (c - D) x + A x.
+  eigen_result r = lanczos(n, threads, eng, true, c,
+                           [&](const vector<double> &x, vector<double> &y,
+                               size_t j, size_t k)
+    {
+      for (size_t v = j; v < k; ++v)
+        {
+          double s = (c - g.degree(v)) * x[v];
+          for (auto a = g.offset(v); a < g.offset(v + 1); ++a)
+            s += x[g.targets()[a]];
+          y[v] = s;
+        }
+    });
+
+  r.value = max(0.0, c - r.value);
+  return r;
+}
+
+eigen_result
+spectral_radius(const csr_graph &g, unsigned threads, const philox &eng)
+{
+  vertex_type n = g.nr_vertices();
+
+  if (n < 1)
+    return eigen_result{0, 0, true};
+
+  // y = A x.
+  return lanczos(n, threads, eng, false, 0,
+                 [&](const vector<double> &x, vector<double> &y,
+                     size_t j, size_t k)
+    {
+      for (size_t v = j; v < k; ++v)
+        {
+          double s = 0;
+          for (auto a = g.offset(v); a < g.offset(v + 1); ++a)
+            s += x[g.targets()[a]];
+          y[v] = s;
+        }
+    });
+}
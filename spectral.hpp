@@ -0,0 +1,51 @@
+#ifndef SPECTRAL_HPP
+#define SPECTRAL_HPP
+
+#include "csr_graph.hpp"
+#include "philox.hpp"
+
+#include <cstdint>
+
+// The stream of the starting vectors, apart from those of the
+// generators, the percolation and the betweenness.
+enum spectral_stream_t {spectral_stream = (1 << 16) + 2};
+
+/**
+ * The eigenvalue found by the Lanczos iteration.
+ */
+struct eigen_result
+{
+  /// The eigenvalue.
+  double value;
+
+  /// The number of the iterations, i.e., the products with the matrix.
+  std::uint32_t iterations;
+
+  /// True if the relative residual dropped below the tolerance before
+  /// the limit of the iterations.
+  bool converged;
+};
+
+/**
+ * The algebraic connectivity: the second smallest eigenvalue of the
+ * Laplacian L = D - A of the graph, where the links have unit
+ * weights.  It is zero if the graph is not connected.
+ *
+ * The Lanczos iteration finds the largest eigenvalue of c I - L,
+ * where c = 2 max degree bounds the spectrum of L, with the constant
+ * vector (the eigenvector of the zero eigenvalue) projected out at
+ * every step.  The iteration stops when the residual is small
+ * relative to the algebraic connectivity, not to c.
+ */
+eigen_result
+algebraic_connectivity(const csr_graph &g, unsigned threads,
+                       const philox &eng);
+
+/**
+ * The spectral radius of the adjacency matrix of the graph, where the
+ * links have unit weights: its largest eigenvalue.
+ */
+eigen_result
+spectral_radius(const csr_graph &g, unsigned threads, const philox &eng);
+
+#endif /* SPECTRAL_HPP */
@@ -0,0 +1,65 @@
+#include "sssp.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+constexpr COST sssp::infinity;
+constexpr uint32_t sssp::none;
+
+void
+sssp::run(const csr_graph &g, vertex_type src)
+{
+  vertex_type n = g.nr_vertices();
+
+  m_dist.assign(n, infinity);
+  m_sigma.assign(n, 0);
+  m_hops.assign(n, 0);
+  m_first.assign(n, none);
+  m_order.clear();
+  m_heap.clear();
+
+  // The min-heap of the tentative distances.  A vertex is pushed
+  // again when its distance improves, and the stale entries are
+  // skipped.
+  greater<pair<COST, vertex_type>> cmp;
+
+  m_dist[src] = 0;
+  m_sigma[src] = 1;
+  m_heap.emplace_back(0, src);
+
+  while (!m_heap.empty())
+    {
+      pop_heap(m_heap.begin(), m_heap.end(), cmp);
+      auto [d, u] = m_heap.back();
+      m_heap.pop_back();
+
+      if (d > m_dist[u])
+        continue;
+
+      m_order.push_back(u);
+
+      for (auto a = g.offset(u); a < g.offset(u + 1); ++a)
+        {
+          vertex_type v = g.targets()[a];
+          COST nd = d + g.weights()[a];
+          uint32_t first = u == src ? a - g.offset(u) : m_first[u];
+
+          if (nd < m_dist[v])
+            {
+              m_dist[v] = nd;
+              m_sigma[v] = m_sigma[u];
+              m_hops[v] = m_hops[u] + 1;
+              m_first[v] = first;
+              m_heap.emplace_back(nd, v);
+              push_heap(m_heap.begin(), m_heap.end(), cmp);
+            }
+          else if (nd == m_dist[v])
+            {
+              m_sigma[v] += m_sigma[u];
+              m_hops[v] = min(m_hops[v], m_hops[u] + 1);
+              m_first[v] = min(m_first[v], first);
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef SSSP_HPP
+#define SSSP_HPP
+
+#include "csr_graph.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/**
+ * The single-source shortest paths on the CSR graph: Dijkstra's
+ * algorithm with a binary heap, which also counts the shortest paths
+ * and their hops.  The object keeps its arrays from run to run, so a
+ * thread should have one, and run it for many sources.
+ *
+ * Along with the distance, a vertex gets the number of the shortest
+ * paths to it (sigma), the fewest hops of a shortest path, and the
+ * first hop of a shortest path: the lowest slot of the arc of the
+ * source that a shortest path starts with.  The hops and the first
+ * hop are taken from the predecessor when the vertex is relaxed, so
+ * they take O(1) per arc, and don't depend on the vertex numbers.
+ * The weights have to be positive.
+ */
+class sssp
+{
+public:
+  typedef csr_graph::vertex_type vertex_type;
+
+  /// The first hop of the source and the unreachable vertexes.
+  static constexpr std::uint32_t none = UINT32_MAX;
+
+  /// The distance of an unreachable vertex.
+  static constexpr COST infinity = std::numeric_limits<COST>::infinity();
+
+  /// Find the shortest paths from the source.
+  void
+  run(const csr_graph &g, vertex_type src);
+
+  /// The distance of vertex v, or infinity.
+  COST
+  dist(vertex_type v) const
+  {
+    return m_dist[v];
+  }
+
+  /// The number of the shortest paths to vertex v.
+  double
+  sigma(vertex_type v) const
+  {
+    return m_sigma[v];
+  }
+
+  /// The fewest hops of a shortest path to vertex v.
+  std::uint32_t
+  hops(vertex_type v) const
+  {
+    return m_hops[v];
+  }
+
+  /// The slot of the first arc of a shortest path to vertex v among
+  /// the arcs of the source, or none for the source and the
+  /// unreachable vertexes.
+  std::uint32_t
+  first(vertex_type v) const
+  {
+    return m_first[v];
+  }
+
+  /// The reachable vertexes in the order of nondecreasing distance,
+  /// starting with the source.
+  const std::vector<vertex_type> &
+  order() const
+  {
+    return m_order;
+  }
+
+private:
+  std::vector<COST> m_dist;
+  std::vector<double> m_sigma;
+  std::vector<std::uint32_t> m_hops;
+  std::vector<std::uint32_t> m_first;
+  std::vector<vertex_type> m_order;
+  std::vector<std::pair<COST, vertex_type>> m_heap;
+};
+
+#endif /* SSSP_HPP */
@@ -0,0 +1,119 @@
+#ifndef STREAM_RANDOM_HPP
+#define STREAM_RANDOM_HPP
+
+#include "cli_args.hpp"
+#include "graph.hpp"
+#include "philox.hpp"
+#include "sampling.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// The streams of the streaming random graph generator.
+enum stream_random_stream {tree_stream, extra_stream, weight_stream};
+
+/**
+ * Generate the random graph edge by edge, and pass the edges to the
+ * sink (with the begin(n), edge(u, v, w) and end() calls) as they are
+ * drawn, without storing them.  Like generate_random_graph, it draws
+ * a connected graph of the requested numbers of nodes and edges,
+ * without loops and parallel edges, with the distances from 1 to 50,
+ * but in two streamable steps:
+ *
+ * - the spanning tree: the vertexes are taken in a random order, and
+ *   every vertex is attached to a random vertex taken before it, so
+ *   the graph is connected by construction,
+ *
+ * - the other edges: they are drawn uniformly from the node pairs
+ *   that are not tree edges, in the increasing order of the pairs,
+ *   with the sequential random sampling (Vitter's Method D), which
+ *   skips the pairs not selected instead of visiting them.
+ *
+ * The memory taken is O(n), not O(m): the random order of the
+ * vertexes, and the sorted numbers of the tree pairs.
+ */
+template <typename S>
+void
+stream_random_graph(const cli_args &args, const philox &eng, S &sink)
+{
+  assert(args.nr_nodes >= 2);
+  assert(args.nr_edges.get() >= args.nr_nodes - 1);
+
+  std::uint64_t n = args.nr_nodes;
+  std::uint64_t m = args.nr_edges.get();
+  std::uint64_t pairs = n * (n - 1) / 2;
+
+  // Fail, because we can't create the requested number of edges.
+  if (m > pairs)
+    abort();
+
+  // The number of the pair (u, v), where u < v, in the row-major
+  // order of the upper triangle.
+  auto pair_number = [n](std::uint64_t u, std::uint64_t v)
+    {
+      if (u > v)
+        std::swap(u, v);
+      return u * (2 * n - u - 1) / 2 + v - u - 1;
+    };
+
+  // The distance of the i-th edge is drawn from the i-th block.
+  philox weights = eng.split(weight_stream);
+  std::uint64_t edge_number = 0;
+  auto emit = [&](std::uint64_t u, std::uint64_t v)
+    {
+      COST w = 1 + scale_to(weights.block(edge_number++)[0], 50);
+      sink.edge(u, v, w);
+    };
+
+  sink.begin(n);
+
+  // The spanning tree.
+  std::vector<std::uint64_t> tree;
+  {
+    philox e = eng.split(tree_stream);
+
+    std::vector<std::uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), e);
+
+    tree.reserve(n - 1);
+    for (std::uint64_t i = 1; i < n; ++i)
+      {
+        std::uint32_t u = order[i];
+        std::uint32_t v = order[std::uniform_int_distribution<std::uint64_t>
+                                (0, i - 1)(e)];
+        tree.push_back(pair_number(u, v));
+        emit(u, v);
+      }
+  }
+  std::sort(tree.begin(), tree.end());
+
+  // The other edges.  The r-th pair that is not a tree edge is the
+  // pair number r + j, where j is the number of the tree pairs before
+  // it.  The selected pairs come in the increasing order, so we walk
+  // along the tree pairs and the rows of the triangle only once.
+  philox e = eng.split(extra_stream);
+  std::uint64_t j = 0;
+  std::uint64_t u = 0, row_end = n - 1;
+
+  sample_sorted(m - (n - 1), pairs - (n - 1), e, [&](std::uint64_t r)
+    {
+      while (j < tree.size() && tree[j] <= r + j)
+        ++j;
+      std::uint64_t p = r + j;
+
+      while (p >= row_end)
+        row_end += n - 1 - ++u;
+      std::uint64_t v = p - (row_end - (n - 1 - u)) + u + 1;
+
+      emit(u, v);
+    });
+
+  sink.end();
+}
+
+#endif /* STREAM_RANDOM_HPP */
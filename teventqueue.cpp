@@ -611,15 +611,39 @@ void convertDelaunay2GabrielGraph(list<TNode*> &P)
     }
 }
 
-list<TNode *> generate_Nodes(unsigned int w, unsigned int h, unsigned int number)
+/**
+ * @brief generate_Nodes draws the locations of the nodes
+ * @param w - the width of the area
+ * @param h - the height of the area
+ * @param number - the number of nodes
+ * @param eng - the counter-based engine
+ * @return the list of nodes sorted by their locations
+ *
+ * The vertexes are split into ranges, and every range draws its first
+ * candidate locations from a stream of its own: the location of the
+ * i-th vertex is given by the (i mod range)-th block of its range
+ * stream.  Only the locations that repeat an earlier one are drawn
+ * again, sequentially, from a separate stream.  The result depends
+ * on the engine key only, no matter how the ranges are drawn.
+ */
+list<TNode *> generate_Nodes(unsigned int w, unsigned int h, unsigned int number, const philox &eng)
 {
-    set<TNode *> P;
+    // The streams used, and the number of vertexes in a range.
+    enum {range_stream, repeat_stream};
+    const unsigned int range = 1 << 12;
+
     set<TMyPoint> testedPoints;
-    unsigned int size;
+    for (unsigned int i = 0; i < number; ++i)
+    {
+      philox::block_type b = eng.split(range_stream, i / range).block(i % range);
+      TMyPoint p(scale_to(b[0], w), scale_to(b[1], h));
+      testedPoints.insert(p);
+    }
+    philox repeat = eng.split(repeat_stream);
     while (testedPoints.size() < number)
     {
-      int x = random() %  w;
-      int y = random() % h;
+      int x = scale_to(repeat(), w);
+      int y = scale_to(repeat(), h);
       TMyPoint p(x, y);
       testedPoints.insert(p);
     }
@@ -1,6 +1,7 @@
 #ifndef TEVENTQUEUE_H
 #define TEVENTQUEUE_H
 #include "mypoint.hpp"
+#include "philox.hpp"
 #include <list>
 #include <set>
 #include <iostream>
@@ -35,7 +36,7 @@ void determine_M(std::list<TNode*> &PP, TMyPoint &p_1, TMyPoint &p_2, TMyPoint &
 void findTriangles(TTriangle *T, TNode *n, TTriangle **t1, TTriangle **t2 );
 void removedoubleNodes(std::list<TNode *> &P);
 void convertDelaunay2GabrielGraph(std::list<TNode*> &P);
-std::list<TNode *> generate_Nodes(unsigned int w, unsigned int h, unsigned int number);
+std::list<TNode *> generate_Nodes(unsigned int w, unsigned int h, unsigned int number, const philox &eng);
 unsigned int edgeNumber(std::list<TNode*> &P);
 
 
@@ -0,0 +1,166 @@
+#include "triangles.hpp"
+
+#include "parallel.hpp"
+
+#include <atomic>
+#include <memory>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+typedef csr_graph::vertex_type vertex_type;
+
+// The number of the nodes a thread takes at a time.
+static const size_t block = 1024;
+
+namespace
+{
+  /**
+   * Call f(x) for every x in both sorted arrays a and b.  With SSE2,
+   * the arrays are merged four elements at a time: the four elements
+   * of a are compared with the four rotations of the four elements of
+   * b, and then the block with the smaller last element is passed.
+   */
+  template <typename F>
+  void
+  intersect(const uint32_t *a, size_t na, const uint32_t *b, size_t nb,
+            F f)
+  {
+    size_t i = 0, j = 0;
+
+#ifdef __SSE2__
+    while (i + 4 <= na && j + 4 <= nb)
+      {
+        __m128i va = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *) (b + j));
+
+        __m128i m0 = _mm_cmpeq_epi32(va, vb);
+        __m128i m1 = _mm_cmpeq_epi32
+          (va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)));
+        __m128i m2 = _mm_cmpeq_epi32
+          (va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m128i m3 = _mm_cmpeq_epi32
+          (va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)));
+        __m128i m = _mm_or_si128(_mm_or_si128(m0, m1),
+                                 _mm_or_si128(m2, m3));
+
+        // The bits of the elements of a found in b.
+        for (int mask = _mm_movemask_ps(_mm_castsi128_ps(m)); mask;
+             mask &= mask - 1)
+          f(a[i + __builtin_ctz(mask)]);
+
+        uint32_t amax = a[i + 3], bmax = b[j + 3];
+        if (amax <= bmax)
+          i += 4;
+        if (bmax <= amax)
+          j += 4;
+      }
+#endif
+
+    while (i < na && j < nb)
+      if (a[i] < b[j])
+        ++i;
+      else if (b[j] < a[i])
+        ++j;
+      else
+        {
+          f(a[i]);
+          ++i;
+          ++j;
+        }
+  }
+}
+
+triangle_result
+triangles(const csr_graph &g, unsigned threads)
+{
+  vertex_type n = g.nr_vertices();
+  size_t blocks = (n + block - 1) / block;
+
+  // True if the link between u and v is oriented from u to v.
+  auto out = [&](vertex_type u, vertex_type v)
+    {
+      return g.degree(u) < g.degree(v) ||
+        (g.degree(u) == g.degree(v) && u < v);
+    };
+
+  // The oriented graph: the links out of every node, sorted by the
+  // node number, as they are in the graph.
+  vector<uint64_t> offsets(n + 1, 0);
+  parallel_for(blocks, threads, [&](size_t b, unsigned)
+    {
+      for (vertex_type u = b * block; u < min<size_t>(n, (b + 1) * block);
+           ++u)
+        for (auto a = g.offset(u); a < g.offset(u + 1); ++a)
+          offsets[u + 1] += out(u, g.targets()[a]);
+    });
+  for (vertex_type u = 0; u < n; ++u)
+    offsets[u + 1] += offsets[u];
+
+  vector<uint32_t> targets(offsets[n]);
+  parallel_for(blocks, threads, [&](size_t b, unsigned)
+    {
+      for (vertex_type u = b * block; u < min<size_t>(n, (b + 1) * block);
+           ++u)
+        {
+          uint64_t i = offsets[u];
+          for (auto a = g.offset(u); a < g.offset(u + 1); ++a)
+            if (out(u, g.targets()[a]))
+              targets[i++] = g.targets()[a];
+        }
+    });
+
+  // The triangles of the nodes, counted by all the threads.
+  unique_ptr<atomic<uint64_t>[]> count(new atomic<uint64_t>[n]());
+
+  parallel_for(blocks, threads, [&](size_t b, unsigned)
+    {
+      for (vertex_type u = b * block; u < min<size_t>(n, (b + 1) * block);
+           ++u)
+        {
+          const uint32_t *uo = targets.data() + offsets[u];
+          size_t un = offsets[u + 1] - offsets[u];
+          uint64_t tu = 0;
+
+          for (size_t k = 0; k < un; ++k)
+            {
+              vertex_type v = uo[k];
+              uint64_t tv = 0;
+
+              intersect(uo, un, targets.data() + offsets[v],
+                        offsets[v + 1] - offsets[v], [&](vertex_type w)
+                {
+                  count[w].fetch_add(1, memory_order_relaxed);
+                  ++tv;
+                });
+
+              if (tv)
+                count[v].fetch_add(tv, memory_order_relaxed);
+              tu += tv;
+            }
+
+          if (tu)
+            count[u].fetch_add(tu, memory_order_relaxed);
+        }
+    });
+
+  triangle_result r;
+  r.node.resize(n);
+  r.triangles = 0;
+  r.wedges = 0;
+
+  for (vertex_type v = 0; v < n; ++v)
+    {
+      r.node[v] = count[v];
+      r.triangles += r.node[v];
+      r.wedges += uint64_t(g.degree(v)) * (g.degree(v) - 1) / 2;
+    }
+
+  // Every triangle was counted at its three nodes.
+  r.triangles /= 3;
+
+  return r;
+}
@@ -0,0 +1,53 @@
+#ifndef TRIANGLES_HPP
+#define TRIANGLES_HPP
+
+#include "csr_graph.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * The triangles of a graph.
+ */
+struct triangle_result
+{
+  /// The number of the triangles every node is in.
+  std::vector<std::uint64_t> node;
+
+  /// The number of the triangles.
+  std::uint64_t triangles;
+
+  /// The number of the wedges, i.e., the paths of two links.
+  std::uint64_t wedges;
+
+  /// The global clustering coefficient (the transitivity): the
+  /// fraction of the wedges closed into triangles.
+  double
+  global() const
+  {
+    return wedges ? 3.0 * triangles / wedges : 0;
+  }
+
+  /// The local clustering coefficient of node v with degree d: the
+  /// fraction of the pairs of its neighbors that are linked, or 0 if
+  /// it has fewer than two neighbors.
+  double
+  local(csr_graph::vertex_type v, std::uint32_t d) const
+  {
+    return d > 1 ? 2.0 * node[v] / (double(d) * (d - 1)) : 0;
+  }
+};
+
+/**
+ * Count the triangles.  Every link is oriented from the node of the
+ * smaller degree to the node of the larger degree (with the ties
+ * broken by the node number), so that a node has at most sqrt(2m)
+ * links out, and every triangle is found once: for link u -> v, as a
+ * node both u and v have links out to.  The nodes are processed in
+ * parallel on the given number of threads, and the links out of two
+ * nodes are intersected by merging, with SSE2 where available.
+ */
+triangle_result
+triangles(const csr_graph &g, unsigned threads);
+
+#endif /* TRIANGLES_HPP */
@@ -0,0 +1,99 @@
+#ifndef UNION_FIND_HPP
+#define UNION_FIND_HPP
+
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/**
+ * The union-find (disjoint sets) of the vertexes, with union by size
+ * and path halving, so that an operation takes O(alpha(n)) amortized
+ * time.  It tracks the number of the components and the size of the
+ * largest one as the edges are added.
+ */
+class union_find
+{
+  std::vector<std::uint32_t> m_parent;
+  std::vector<std::uint32_t> m_size;
+  std::uint32_t m_count;
+  std::uint32_t m_largest;
+
+public:
+  explicit union_find(std::uint32_t n = 0)
+  {
+    reset(n);
+  }
+
+  /// Make n singletons, reusing the memory.
+  void
+  reset(std::uint32_t n)
+  {
+    m_parent.resize(n);
+    std::iota(m_parent.begin(), m_parent.end(), 0);
+    m_size.assign(n, 1);
+    m_count = n;
+    m_largest = n ? 1 : 0;
+  }
+
+  /// The representative of the set of vertex v.
+  std::uint32_t
+  find(std::uint32_t v)
+  {
+    while (m_parent[v] != v)
+      {
+        m_parent[v] = m_parent[m_parent[v]];
+        v = m_parent[v];
+      }
+    return v;
+  }
+
+  /**
+   * Unite the sets of vertexes u and v.
+   *
+   * @return true if they were different sets
+   */
+  bool
+  unite(std::uint32_t u, std::uint32_t v)
+  {
+    u = find(u);
+    v = find(v);
+
+    if (u == v)
+      return false;
+
+    if (m_size[u] < m_size[v])
+      std::swap(u, v);
+
+    m_parent[v] = u;
+    m_size[u] += m_size[v];
+    --m_count;
+    if (m_largest < m_size[u])
+      m_largest = m_size[u];
+
+    return true;
+  }
+
+  /// The size of the set of vertex v.
+  std::uint32_t
+  size(std::uint32_t v)
+  {
+    return m_size[find(v)];
+  }
+
+  /// The number of the sets.
+  std::uint32_t
+  count() const
+  {
+    return m_count;
+  }
+
+  /// The size of the largest set.
+  std::uint32_t
+  largest() const
+  {
+    return m_largest;
+  }
+};
+
+#endif /* UNION_FIND_HPP */
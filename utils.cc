@@ -1,11 +1,8 @@
 #include "utils.hpp"
 
-#include <boost/graph/dijkstra_shortest_paths.hpp>
-#include <boost/range.hpp>
+#include "sssp.hpp"
 
-#include <cmath>
-#include <iomanip>
-#include <sstream>
+#include <boost/range.hpp>
 
 using namespace std;
 
@@ -19,53 +16,113 @@ nt_interpret (const string &nt)
   return interpret ("network type", nt, nt_map);
 }
 
-void
-name_vertices(graph &g)
+// Handles the output format parameter.
+format_t
+format_interpret (const string &format)
 {
-  int count = 1;
+  map <string, format_t> format_map;
+  format_map["dot"] = format_t::dot;
+  format_map["bin"] = format_t::bin;
+  format_map["edges"] = format_t::edges;
+  format_map["metis"] = format_t::metis;
+  format_map["graphml"] = format_t::graphml;
+  return interpret ("output format", format, format_map);
+}
 
-  int number = num_vertices(g);
-  int width = int(log10(number)) + 1;
+// Handles the vertex order parameter.
+order_t
+order_interpret (const string &order)
+{
+  map <string, order_t> order_map;
+  order_map["none"] = order_t::none;
+  order_map["hilbert"] = order_t::hilbert;
+  order_map["rcm"] = order_t::rcm;
+  order_map["degree"] = order_t::degree;
+  return interpret ("vertex order", order, order_map);
+}
 
-  for(vertex v: boost::make_iterator_range(vertices(g)))
-    {
-      ostringstream out;
-      out << "v" << setw(width) << setfill('0') << count++;
-      boost::get(boost::vertex_name, g, v) = out.str();
-    }
+// Handles the analysis parameter.
+analysis_t
+analysis_interpret (const string &mode)
+{
+  map <string, analysis_t> mode_map;
+  mode_map["stats"] = analysis_t::stats;
+  mode_map["percolation"] = analysis_t::percolation;
+  mode_map["betweenness"] = analysis_t::betweenness;
+  mode_map["diameter"] = analysis_t::diameter;
+  mode_map["eccentricity"] = analysis_t::eccentricity;
+  mode_map["clustering"] = analysis_t::clustering;
+  mode_map["spectrum"] = analysis_t::spectrum;
+  mode_map["cuts"] = analysis_t::cuts;
+  mode_map["query"] = analysis_t::query;
+  return interpret ("analysis", mode, mode_map);
+}
+
+// Handles the percolation attack parameter.
+attack_t
+attack_interpret (const string &attack)
+{
+  map <string, attack_t> attack_map;
+  attack_map["random-nodes"] = attack_t::random_nodes;
+  attack_map["degree-nodes"] = attack_t::degree_nodes;
+  attack_map["random-links"] = attack_t::random_links;
+  attack_map["degree-links"] = attack_t::degree_links;
+  return interpret ("attack", attack, attack_map);
+}
+
+// Handles the survivable parameter.
+survivable_t
+survivable_interpret (const string &survivable)
+{
+  map <string, survivable_t> survivable_map;
+  survivable_map["none"] = survivable_t::none;
+  survivable_map["2-edge"] = survivable_t::edge;
+  survivable_map["2-vertex"] = survivable_t::vertex;
+  return interpret ("survivable", survivable, survivable_map);
+}
+
+// Handles the statistics format parameter.
+stats_format_t
+stats_format_interpret (const string &stats_format)
+{
+  map <string, stats_format_t> stats_format_map;
+  stats_format_map["text"] = stats_format_t::text;
+  stats_format_map["json"] = stats_format_t::json;
+  return interpret ("statistics format", stats_format, stats_format_map);
 }
 
-void
-calc_sp_stats(const graph &g, dbl_acc &hop_acc, dbl_acc &len_acc)
+uint64_t
+calc_sp_stats(const csr_graph &g, histogram_acc &hop_acc,
+              quantile_acc &len_acc)
 {
+  typedef csr_graph::vertex_type vertex;
+
+  uint64_t unreachable = 0;
+
+  sssp sp;
+
   // Calculate stats for shortest paths.
-  for (vertex src: boost::make_iterator_range(boost::vertices(g)))
+  for (vertex src: boost::make_iterator_range(vertices(g)))
     {
-      vector<int> dist(num_vertices(g));
-      vector<vertex> pred(num_vertices(g));
+      sp.run(g, src);
 
-      boost::dijkstra_shortest_paths
-        (g, src,
-         boost::predecessor_map(&pred[0]).distance_map(&dist[0]));
-
-      for (vertex dst: boost::make_iterator_range(boost::vertices(g)))
+      for (vertex dst: boost::make_iterator_range(vertices(g)))
         if (src != dst)
           {
-            // Make sure the path was found.
-            assert(pred[dst] != dst);
-
-            // Record the number of hops.
-            int hops = 0;
-            vertex c = dst;
-            while(c != src)
+            // Skip the node without a path.
+            if (sp.dist(dst) == sssp::infinity)
               {
-                c = pred[c];
-                ++hops;
+                ++unreachable;
+                continue;
               }
-            hop_acc(hops);
+
+            // Record the number of hops.
+            hop_acc(sp.hops(dst));
 
             // Record the path length.
-            len_acc(dist[dst]);
+            len_acc(sp.dist(dst));
           }
     }
+
+  return unreachable;
 }
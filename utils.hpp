@@ -2,34 +2,38 @@
 #define UTILS_HPP
 
 #include "cli_args.hpp"
+#include "csr_graph.hpp"
+#include "dbl_acc.hpp"
 #include "graph.hpp"
+#include "histogram_acc.hpp"
+#include "quantile_acc.hpp"
+#include "union_find.hpp"
 #include "utils.hpp"
 
-#include <boost/graph/connected_components.hpp>
-
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics.hpp>
-#include <boost/accumulators/statistics/mean.hpp>
-#include <boost/accumulators/statistics/variance.hpp>
+#include <boost/range.hpp>
 
 #include <iostream>
 
-namespace ba = boost::accumulators;
-
-// The accumulator with double values.                                                                      
-typedef ba::accumulator_set<double, ba::stats<ba::tag::min,
-                                              ba::tag::mean,
-                                              ba::tag::max,
-                                              ba::tag::variance> > dbl_acc;
-
 nt_t
 nt_interpret (const string &nt);
 
-/**
- * Names the vertices.
- */
-void
-name_vertices(graph &g);
+format_t
+format_interpret (const string &format);
+
+order_t
+order_interpret (const string &order);
+
+analysis_t
+analysis_interpret (const string &mode);
+
+attack_t
+attack_interpret (const string &attack);
+
+survivable_t
+survivable_interpret (const string &survivable);
+
+stats_format_t
+stats_format_interpret (const string &stats_format);
 
 /**
  * Return a container with vertexes of a graph.
@@ -48,7 +52,10 @@ get_vertexes(const graph &g)
 }
 
 /**
- * True if the graph is connected.
+ * True if the graph is connected.  The vertexes of every edge are
+ * united in the union-find, which takes O(n) memory on the heap.  The
+ * generated graphs don't need it, since the generators keep track of
+ * their connectivity.
  *
  * @return: true if the graph is connected, false otherwise.
  */
@@ -56,12 +63,13 @@ template<typename G>
 bool
 is_connected(const G &g)
 {
-  int c[boost::num_vertices(g)];
+  union_find uf(num_vertices(g));
 
-  // "num" is the number of connected components.
-  int num = boost::connected_components(g, c);
+  for (auto v: boost::make_iterator_range(vertices(g)))
+    for (auto e: boost::make_iterator_range(out_edges(v, g)))
+      uf.unite(v, target(e, g));
 
-  return num == 1;
+  return uf.count() == 1;
 }
 
 /**
@@ -114,8 +122,11 @@ interpret(const std::string &name, const std::string &text,
 }
 
 // For the shortest paths between all node pairs, calculate the
-// statistics for hops and lengths.
-void
-calc_sp_stats(const graph &g, dbl_acc &hop_acc, dbl_acc &len_acc);
+// statistics for hops and lengths.  The hops are the fewest hops of
+// the shortest paths between the nodes.  Return the number of the
+// ordered node pairs without a path, which are skipped.
+std::uint64_t
+calc_sp_stats(const csr_graph &g, histogram_acc &hop_acc,
+              quantile_acc &len_acc);
 
 #endif /* UTILS_HPP */